@@ -1,6 +1,9 @@
 #define OLC_PGE_APPLICATION
 #include "olcPixelGameEngine.h"
 
+#include "src/trace.h"
+#define PGEX_MA_TRACE_SCOPE(name, detail) Trace::Scope pgexTraceScope(name, detail)
+#define PGEX_MA_TRACE_THREAD(name) Trace::SetThreadName(name)
 #define OLC_PGEX_MINIAUDIO
 #include "olcPGEX_MiniAudio.h"
 
@@ -8,10 +11,25 @@
 #include "src/player.h"
 #include "src/asteroid.h"
 #include "src/bullet.h"
+#include "src/collision.h"
 #include "src/enemy.h"
 #include "src/enemy_bullet.h"
 #include "src/enemy_boss.h"
-
+#include "src/asset_cache.h"
+#include "src/startup_profiler.h"
+#include "src/hot_reload.h"
+#include "src/audio_queue.h"
+#include "src/audio_events.h"
+#include "src/music_manager.h"
+#include "src/sfx_bank.h"
+#include "src/replay.h"
+#include "src/rng.h"
+#include "src/snapshot.h"
+#include "src/frame_profiler.h"
+#include "src/alloc_tracker.h"
+#include "src/frame_capture.h"
+
+#include <array>
 #include <vector>
 #include <random>
 #include <algorithm>
@@ -19,6 +37,10 @@
 #include <cmath>
 #include <fstream>
 #include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
 
 // ============================================================================
 // GAME LOGIC
@@ -47,52 +69,101 @@ public:
     }
 
     // ============================================================================
-    // DESTRUCTOR - Fix Memory Leaks
+    // STARTUP PROFILING
     // ============================================================================
-    ~SpaceShooter() {
-        // Clean up decals first (they reference sprites)
-        delete decBackground;
-        delete decPlayer;
-        delete decAsteroid;
-        delete decEnemy;
-        delete decBoss;
-        delete decBullet;
-        delete decEnemyBullet;
-        delete decBoomAsteroid;
-        delete decBoomShip;
-
-        // Then clean up sprites
-        delete sprBackground;
-        delete sprPlayer;
-        delete sprAsteroid;
-        delete sprEnemy;
-        delete sprBoss;
-        delete sprBullet;
-        delete sprEnemyBullet;
-        delete sprBoomAsteroid;
-        delete sprBoomShip;
-
-        // Clean up story decals and sprites
-        for (auto* d : storyDecals) delete d;
-        for (auto* s : storySprites) delete s;
-        
-        for (auto* d : storyL2Decals) delete d;
-        for (auto* s : storyL2Sprites) delete s;
-        
-        for (auto* d : storyL3Decals) delete d;
-        for (auto* s : storyL3Sprites) delete s;
-        
-        for (auto* d : storyGODecals) delete d;
-        for (auto* s : storyGOSprites) delete s;
-        
-        for (auto* d : storyVictoryDecals) delete d;
-        for (auto* s : storyVictorySprites) delete s;
+    // First member, so tracing covers the audio engine's creation and the trace
+    // is written after every other member has stopped its threads. The audio
+    // threads' buffers are reserved here, as they must not allocate themselves
+    Trace::Session trace{ GameConfig::TRACE_EVENTS_PER_THREAD, { "audio device", "audio null device" } };
+    // Next, so its clock starts before the audio engine is created
+    StartupProfiler startup;
+    bool startupOverBudget = false;
+
+    void finishStartupProfile() {
+        const auto& audioInit = audio.GetInitTimings();
+        startup.AddPhaseTime("audio device init", audioInit.m_device_ms);
+        startup.AddPhaseTime("audio resource manager init", audioInit.m_resource_manager_ms);
+        startup.AddPhaseTime("ma_engine_init", audioInit.m_engine_ms);
+
+        float budgetMs = GameConfig::STARTUP_BUDGET_MS;
+        if (const char* env = std::getenv("STARFALL_STARTUP_BUDGET_MS")) {
+            budgetMs = float(std::atof(env));
+        }
+        startup.SetBudgetMs(budgetMs);
+
+        startup.Finish();
+        startup.PrintSummary();
+        startup.WriteJson(GameConfig::STARTUP_REPORT_FILE);
+        startupOverBudget = startup.IsOverBudget();
     }
 
     // ============================================================================
     // AUDIO SYSTEM
     // ============================================================================
-    olc::MiniAudio audio;
+    // STARFALL_AUDIO=null mixes without a sound card (headless CI hosts);
+    // hosts with no device fall back to the null device on their own
+    static olc::MiniAudio::DeviceSettings audioSettings() {
+        olc::MiniAudio::DeviceSettings settings;
+        settings.m_sample_rate = GameConfig::AUDIO_SAMPLE_RATE;
+        settings.m_period_size_in_frames = GameConfig::AUDIO_PERIOD_FRAMES;
+        settings.m_periods = GameConfig::AUDIO_PERIODS;
+
+        const char* env = std::getenv("STARFALL_AUDIO");
+        if (env && std::string(env) == "null") settings.m_mode = olc::MiniAudio::DeviceMode::Null;
+#ifdef STARFALL_SIM
+        // Simulated runs mix on the simulation thread, a tick's worth after each tick, so the
+        // mix follows simulated time rather than the wall clock
+        settings.m_mode = olc::MiniAudio::DeviceMode::Manual;
+#endif
+        envOverride("STARFALL_AUDIO_RATE", settings.m_sample_rate, GameConfig::AUDIO_MIN_SAMPLE_RATE, GameConfig::AUDIO_MAX_SAMPLE_RATE);
+        envOverride("STARFALL_AUDIO_PERIOD", settings.m_period_size_in_frames, 0, GameConfig::AUDIO_MAX_PERIOD_FRAMES);
+        envOverride("STARFALL_AUDIO_PERIODS", settings.m_periods, 0, GameConfig::AUDIO_MAX_PERIODS);
+        return settings;
+    }
+
+    // Replaces value with the variable's if it is set to a whole number in [min, max]; anything else is reported and ignored
+    static void envOverride(const char* name, ma_uint32& value, unsigned min, unsigned max) {
+        const char* env = std::getenv(name);
+        if (!env) return;
+
+        char* end = nullptr;
+        unsigned long parsed = std::strtoul(env, &end, 10);
+        if (end == env || *end != '\0' || env[0] == '-' || parsed < min || parsed > max) {
+            std::cerr << "ERROR: Ignoring " << name << "=" << env << ", expected a whole number from "
+                      << min << " to " << max << std::endl;
+            return;
+        }
+        value = ma_uint32(parsed);
+    }
+
+    olc::MiniAudio audio{ audioSettings() };
+    SfxBank sfxBank{ audio, GameConfig::SFX_CACHE_DIR };
+
+    // Shared sprites/decals/sounds, deduplicated by path. Declared after the
+    // audio engine and before the handles so it outlives every handle.
+    AssetCache assets{ &audio };
+    AudioCommandQueue audioQueue{ audio };  // Declared before the handles, whose unloads it applies as it stops
+    std::vector<AssetCache::SoundHandle> soundHandles;
+    AudioEventAggregator sfxEvents;         // One-shot effects requested this frame, submitted at its end
+
+    // Where positional effects come from. The ship and the boss are followed as
+    // they move; the rest are fixed spots, like an explosion, whose pan and
+    // gain only change as the player moves away from them
+    struct SoundEmitter {
+        olc::vf2d pos;
+        float life = 0.0f;          // Seconds a spot is still updated for
+        float pan = 0.0f;           // As last sent
+        float gain = 1.0f;
+    };
+    static constexpr int EMITTER_PLAYER = 0;
+    static constexpr int EMITTER_BOSS = 1;
+    static constexpr int EMITTER_FIRST_POINT = 2;
+    std::array<SoundEmitter, EMITTER_FIRST_POINT + GameConfig::SFX_POINT_EMITTERS> soundEmitters{};
+    int nextPointEmitter = 0;
+    MusicManager music{ audio, audioQueue };
+    AssetHotReload hotReload{ assets };
+    FrameProfiler profiler{ GameConfig::FRAME_PROFILE_FRAMES };  // F3 shows the per-phase overlay
+    AllocationMonitor allocations{ GameConfig::ALLOC_BUDGET_PER_FRAME };  // F4, with STARFALL_ALLOC_TRACKING
     
     // Sound IDs
     int sndShoot = -1;
@@ -110,21 +181,41 @@ public:
     void loadAudioFiles() {
         std::cout << "Loading audio files..." << std::endl;
         
+        if (GameConfig::PROCEDURAL_SFX) {
+            StartupProfiler::Scope timer(startup, "procedural sfx");
+            buildSfxBank();
+        }
+
         // Try to load audio files - these will be optional
-        sndShoot = audio.LoadSound("assets/audio/shoot.wav");
-        sndExplosionSmall = audio.LoadSound("assets/audio/explosion_small.wav");
-        sndExplosionLarge = audio.LoadSound("assets/audio/explosion_large.wav");
-        sndPowerUp = audio.LoadSound("assets/audio/powerup.wav");
-        sndPlayerHit = audio.LoadSound("assets/audio/player_hit.wav");
-        sndLevelComplete = audio.LoadSound("assets/audio/level_complete.wav");
-        sndGameOver = audio.LoadSound("assets/audio/game_over.wav");
-        sndMenuSelect = audio.LoadSound("assets/audio/menu_select.wav");
-        sndBossHit = audio.LoadSound("assets/audio/boss_hit.wav");
-
-        // Story Music (optional)
-        sndStoryEpic = audio.LoadSound("assets/audio/story_epic.wav");
-        sndStorySad = audio.LoadSound("assets/audio/story_sad.wav");
-        sndStoryTriumph = audio.LoadSound("assets/audio/story_triumph.wav");
+        sndShoot = proceduralOrFile("shoot", "assets/audio/shoot.wav");
+        sndExplosionSmall = loadSound("assets/audio/explosion_small.wav");
+        sndExplosionLarge = loadSound("assets/audio/explosion_large.wav");
+        sndPowerUp = proceduralOrFile("powerup", "assets/audio/powerup.wav");
+        sndPlayerHit = loadSound("assets/audio/player_hit.wav");
+        sndLevelComplete = loadSound("assets/audio/level_complete.wav");
+        sndGameOver = loadSound("assets/audio/game_over.wav");
+        sndMenuSelect = proceduralOrFile("menu_select", "assets/audio/menu_select.wav");
+        sndBossHit = proceduralOrFile("boss_hit", "assets/audio/boss_hit.wav");
+
+        // Every effect gets its own voices so rapid fire and chained explosions layer instead of cutting out
+        for (int id : sfxIds()) {
+            if (id >= 0) audio.CreateVoicePool(id, GameConfig::SFX_VOICES);
+        }
+        for (int id : sfxBank.GetIds()) {
+            if (audio.GetVoiceStats(id).m_voices == 0) audio.CreateVoicePool(id, GameConfig::SFX_VOICES);
+            sfxEvents.Reserve(id);
+        }
+        for (int id : sfxIds()) sfxEvents.Reserve(id);
+        sfxEvents.SetRateLimit(sndExplosionSmall, GameConfig::SFX_EXPLOSION_SMALL_INTERVAL);
+        sfxEvents.SetRateLimit(sndExplosionLarge, GameConfig::SFX_EXPLOSION_LARGE_INTERVAL);
+        sfxEvents.SetRateLimit(sndBossHit, GameConfig::SFX_BOSS_HIT_INTERVAL);
+        music.SetVolume(GameConfig::MUSIC_VOLUME);
+        music.SetFadeSeconds(GameConfig::MUSIC_FADE_SECONDS);
+
+        // Story Music (optional) - streamed from disk, these are far too long to keep decoded
+        sndStoryEpic = loadSound("assets/audio/story_epic.wav", true);
+        sndStorySad = loadSound("assets/audio/story_sad.wav", true);
+        sndStoryTriumph = loadSound("assets/audio/story_triumph.wav", true);
 
         // Debug output for story music loading
         std::cout << "Story Music Loading Status:" << std::endl;
@@ -132,14 +223,178 @@ public:
         std::cout << "  - Sad: " << (sndStorySad >= 0 ? "OK" : "FAILED") << " (ID: " << sndStorySad << ")" << std::endl;
         std::cout << "  - Triumph: " << (sndStoryTriumph >= 0 ? "OK" : "FAILED") << " (ID: " << sndStoryTriumph << ")" << std::endl;
 
+        // From here on playback goes through the queue's control thread. Without a
+        // device nothing mixes concurrently, so commands are applied as they are
+        // made and the offline mix depends only on what the game did
+        assets.SetAudioQueue(&audioQueue);
+        if (audio.GetDeviceMode() == olc::MiniAudio::DeviceMode::Hardware) audioQueue.Start();
+
+        // Every emitter sent once up front, so the engine's emitter table is full size
+        // before gameplay, where without a control thread it would grow on this one
+        for (int i = 0; i < int(soundEmitters.size()); i++) {
+            audioQueue.SetEmitter(i, soundEmitters[i].pan, soundEmitters[i].gain);
+        }
+
+        const auto& device = audio.GetDeviceSettings();
+        std::cout << "Audio device: " << device.m_sample_rate << " Hz, " << device.m_period_size_in_frames
+                  << " frame periods x " << device.m_periods << std::endl;
+        audio.SetLatencyProbe(GameConfig::AUDIO_LATENCY_PROBE);
+
+        // STARFALL_AUDIO_WAV=<file> records the null device's (or the simulator's) mix for offline comparison
+        if (audio.GetDeviceMode() == olc::MiniAudio::DeviceMode::Manual) {
+            std::cout << "Audio: no device, mixed offline as the simulation runs" << std::endl;
+        }
+        else if (audio.GetDeviceMode() == olc::MiniAudio::DeviceMode::Null) {
+            std::cout << "Audio: no hardware device, mixing to the null device" << std::endl;
+        }
+        if (audio.GetDeviceMode() != olc::MiniAudio::DeviceMode::Hardware) {
+            if (const char* wav = std::getenv("STARFALL_AUDIO_WAV")) {
+                if (!audio.StartRecording(wav)) {
+                    std::cerr << "ERROR: Could not record audio to: " << wav << std::endl;
+                }
+            }
+        }
+
         audioLoaded = true;
         std::cout << "Audio loading complete." << std::endl;
     }
 
+    // Synthesised replacements for the short effects, rendered in parallel or read back from the cache
+    void buildSfxBank() {
+        SfxParams shoot;
+        shoot.wave = ma_waveform_type_square;
+        shoot.startHz = 880.0f;
+        shoot.endHz = 440.0f;
+        shoot.duration = 0.12f;
+        shoot.attack = 0.002f;
+        shoot.decayCurve = 2.0f;
+        shoot.amplitude = 0.35f;
+        sfxBank.Add("shoot", shoot, GameConfig::SFX_SHOOT_VARIATIONS, GameConfig::SFX_SHOOT_PITCH_JITTER);
+
+        SfxParams powerUp;
+        powerUp.wave = ma_waveform_type_triangle;
+        powerUp.startHz = 440.0f;
+        powerUp.endHz = 1320.0f;
+        powerUp.duration = 0.35f;
+        powerUp.amplitude = 0.5f;
+        sfxBank.Add("powerup", powerUp);
+
+        SfxParams menuSelect;
+        menuSelect.wave = ma_waveform_type_sine;
+        menuSelect.startHz = 660.0f;
+        menuSelect.endHz = 990.0f;
+        menuSelect.duration = 0.08f;
+        menuSelect.decayCurve = 1.5f;
+        menuSelect.amplitude = 0.5f;
+        sfxBank.Add("menu_select", menuSelect);
+
+        SfxParams bossHit;
+        bossHit.wave = ma_waveform_type_sawtooth;
+        bossHit.startHz = 220.0f;
+        bossHit.endHz = 110.0f;
+        bossHit.duration = 0.18f;
+        bossHit.decayCurve = 2.0f;
+        bossHit.noise = 0.4f;
+        bossHit.noiseType = ma_noise_type_brownian;
+        bossHit.amplitude = 0.5f;
+        sfxBank.Add("boss_hit", bossHit);
+
+        if (!sfxBank.Build()) {
+            std::cerr << "ERROR: Some procedural sounds failed, falling back to their WAV files" << std::endl;
+        }
+        const auto& stats = sfxBank.GetStats();
+        std::cout << "Procedural SFX: " << stats.sounds << " sounds (" << stats.rendered << " rendered, "
+                  << stats.cached << " cached) in " << stats.ms << " ms" << std::endl;
+    }
+
+    int proceduralOrFile(const std::string& name, const std::string& path) {
+        int id = sfxBank.Get(name);
+        return (id >= 0) ? id : loadSound(path);
+    }
+
+    // Loads through the asset cache and keeps the handle alive for the game's lifetime
+    int loadSound(const std::string& path, bool stream = false) {
+        AssetCache::SoundHandle handle = assets.LoadSound(path, stream);
+        if (!handle) return -1;
+        soundHandles.push_back(handle);
+        return *handle;
+    }
+
     void playSound(int soundId, float volume = 1.0f) {
+        AllocTracker::Scope tagged("playSound");
         if (audioLoaded && soundId >= 0) {
-            audio.SetVolume(soundId, volume);
-            audio.Play(soundId, false);  // false = no looping
+            sfxEvents.Request(soundId, volume);
+        }
+    }
+
+    // Positional one-shot from a fixed spot: pans with its screen x and fades with its distance from the player
+    void playSoundAt(int soundId, olc::vf2d pos, float volume = 1.0f) {
+        if (!audioLoaded || soundId < 0) return;
+
+        int emitter = EMITTER_FIRST_POINT + nextPointEmitter;
+        nextPointEmitter = (nextPointEmitter + 1) % GameConfig::SFX_POINT_EMITTERS;
+        soundEmitters[emitter].pos = pos;
+        soundEmitters[emitter].life = GameConfig::SFX_EMITTER_SECONDS;
+        playSoundFrom(soundId, emitter, volume);
+    }
+
+    // Positional one-shot that keeps following the emitter while it plays
+    void playSoundFrom(int soundId, int emitter, float volume = 1.0f) {
+        AllocTracker::Scope tagged("playSound");
+        if (!audioLoaded || soundId < 0) return;
+
+        // Sent ahead of the play, so the voice starts out already panned
+        sendSoundEmitter(emitter);
+        sfxEvents.RequestAt(soundId, emitter, volume);
+    }
+
+    void sendSoundEmitter(int emitter) {
+        SoundEmitter& e = soundEmitters[emitter];
+        if (emitter == EMITTER_PLAYER) e.pos = player.pos;
+        if (emitter == EMITTER_BOSS) e.pos = boss.pos;
+
+        float pan = std::clamp(e.pos.x / float(ScreenWidth()) * 2.0f - 1.0f, -1.0f, 1.0f) * GameConfig::SFX_PAN_WIDTH;
+        float falloff = std::clamp(((e.pos - player.pos).mag() - GameConfig::SFX_FULL_VOLUME_DISTANCE) / GameConfig::SFX_FALLOFF_DISTANCE, 0.0f, 1.0f);
+        float gain = 1.0f - falloff * (1.0f - GameConfig::SFX_MIN_DISTANCE_GAIN);
+        if (pan == e.pan && gain == e.gain) return;
+
+        e.pan = pan;
+        e.gain = gain;
+        audioQueue.SetEmitter(emitter, pan, gain);
+    }
+
+    // End of a frame: moves every emitter still sounding, then starts this
+    // frame's merged effects. The voices following the emitters are all
+    // updated in one pass on the audio control thread, which also unloads
+    // the one-shots that have finished
+    void submitSounds(float dt) {
+        if (audioLoaded) {
+            for (int i = 0; i < int(soundEmitters.size()); i++) {
+                if (i >= EMITTER_FIRST_POINT) {
+                    if (soundEmitters[i].life <= 0.0f) continue;
+                    soundEmitters[i].life -= dt;
+                }
+                sendSoundEmitter(i);
+            }
+            audioQueue.UpdateEmitters();
+            audioQueue.ReapFinished();
+        }
+        sfxEvents.Submit(audioQueue, dt);
+    }
+
+    std::array<int, 9> sfxIds() const {
+        return { sndShoot, sndExplosionSmall, sndExplosionLarge, sndPowerUp, sndPlayerHit,
+                 sndLevelComplete, sndGameOver, sndMenuSelect, sndBossHit };
+    }
+
+    void printVoiceStats() {
+        audioQueue.Flush();
+        std::cout << "Sound effect voices:" << std::endl;
+        for (int id : sfxIds()) {
+            if (id < 0) continue;
+            auto stats = audio.GetVoiceStats(id);
+            std::cout << "  - sound " << id << ": " << stats.m_plays << " plays, peak "
+                      << stats.m_peak_active << "/" << stats.m_voices << " voices, " << stats.m_steals << " stolen" << std::endl;
         }
     }
 
@@ -150,6 +405,10 @@ public:
         float timer = 0.0f;
         float maxTime = 0.25f;
         float scale = 1.0f;
+
+        // Snapshot hooks; the decal is saved by the game, as which sprite it was
+        void Save(SnapshotWriter& out) const { out.Write(pos); out.Write(timer); out.Write(maxTime); out.Write(scale); }
+        void Load(SnapshotReader& in) { in.Read(pos); in.Read(timer); in.Read(maxTime); in.Read(scale); }
     };
     std::vector<Explosion> explosions;
 
@@ -161,6 +420,9 @@ public:
         float r = GameConfig::POWERUP_RADIUS;
         bool alive = true;
 
+        void Save(SnapshotWriter& out) const { out.Write(pos); out.Write(vel); out.Write(type); out.Write(r); out.Write(alive); }
+        void Load(SnapshotReader& in) { in.Read(pos); in.Read(vel); in.Read(type); in.Read(r); in.Read(alive); }
+
         void Update(float dt, int screenH) {
             pos += vel * dt;
             if (pos.y - r > screenH + 20.0f) {
@@ -188,61 +450,46 @@ public:
     };
     std::vector<PowerUp> powerups;
 
-    // --- Sprites & decals ---
-    olc::Sprite* sprBackground = nullptr;
-    olc::Decal* decBackground = nullptr;
-
-    olc::Sprite* sprPlayer = nullptr;
-    olc::Decal* decPlayer = nullptr;
-
-    olc::Sprite* sprAsteroid = nullptr;
-    olc::Decal* decAsteroid = nullptr;
-
-    olc::Sprite* sprEnemy = nullptr;
-    olc::Decal* decEnemy = nullptr;
-
-    olc::Sprite* sprBoss = nullptr;
-    olc::Decal* decBoss = nullptr;
-
-    olc::Sprite* sprBullet = nullptr;
-    olc::Decal* decBullet = nullptr;
-
-    olc::Sprite* sprEnemyBullet = nullptr; // New
-    olc::Decal* decEnemyBullet = nullptr; // New
-
-    olc::Sprite* sprBoomAsteroid = nullptr;
-    olc::Decal* decBoomAsteroid = nullptr;
+    // --- Sprites & decals (owned by the asset cache) ---
+    enum class SpriteId {
+        BACKGROUND,
+        PLAYER,
+        ASTEROID,
+        ENEMY,
+        BOSS,
+        BULLET,
+        ENEMY_BULLET,
+        BOOM_ASTEROID,
+        BOOM_SHIP,
+        COUNT
+    };
+    std::array<AssetCache::SpriteHandle, size_t(SpriteId::COUNT)> sprites;
 
-    olc::Sprite* sprBoomShip = nullptr;
-    olc::Decal* decBoomShip = nullptr;
+    olc::Sprite* spr(SpriteId id) const { return sprites[size_t(id)]->sprite.get(); }
+    olc::Decal* dec(SpriteId id) const { return sprites[size_t(id)]->decal.get(); }
 
-    // Story Sprites & Decals
-    std::vector<olc::Sprite*> storySprites;
-    std::vector<olc::Decal*> storyDecals;
+    // Story Slides
+    std::vector<AssetCache::SpriteHandle> storySlides;
     int storyIndex = 0;
     std::vector<std::string> storyText;
 
-    // Story Level 2 Sprites & Decals
-    std::vector<olc::Sprite*> storyL2Sprites;
-    std::vector<olc::Decal*> storyL2Decals;
+    // Story Level 2 Slides
+    std::vector<AssetCache::SpriteHandle> storyL2Slides;
     int storyL2Index = 0;
     std::vector<std::string> storyL2Text;
 
-    // Story Level 3 Sprites & Decals
-    std::vector<olc::Sprite*> storyL3Sprites;
-    std::vector<olc::Decal*> storyL3Decals;
+    // Story Level 3 Slides
+    std::vector<AssetCache::SpriteHandle> storyL3Slides;
     int storyL3Index = 0;
     std::vector<std::string> storyL3Text;
 
-    // Story Game Over (Mission Failed) Sprites & Decals
-    std::vector<olc::Sprite*> storyGOSprites;
-    std::vector<olc::Decal*> storyGODecals;
+    // Story Game Over (Mission Failed) Slides
+    std::vector<AssetCache::SpriteHandle> storyGOSlides;
     int storyGOIndex = 0;
     std::vector<std::string> storyGOText;
 
-    // Story Victory (Happy Ending) Sprites & Decals
-    std::vector<olc::Sprite*> storyVictorySprites;
-    std::vector<olc::Decal*> storyVictoryDecals;
+    // Story Victory (Happy Ending) Slides
+    std::vector<AssetCache::SpriteHandle> storyVictorySlides;
     int storyVictoryIndex = 0;
     std::vector<std::string> storyVictoryText;
 
@@ -253,8 +500,6 @@ public:
     float storyParallaxTime = 0.0f;      // For parallax motion
     float storySkipTimer = 0.0f;         // For skip detection (ESC hold)
     bool storyFadingIn = true;           // Fade state
-    bool storyMusicPlaying = false;      // Track if story music is currently playing
-    int currentStoryMusic = -1;          // Currently playing story music ID
 
     // Story Music IDs
     int sndStoryEpic = -1;
@@ -272,8 +517,18 @@ public:
     Boss boss;
     std::vector<EnemyBullet> enemyBullets;
 
-    // Random
-    std::mt19937 rng{ std::random_device{}() };
+    // Random: one stream of the run's seed per subsystem, so extra draws in one
+    // (a new cosmetic effect, a frame rendered twice) never change another's numbers
+    enum RngStream : uint32_t { RNG_SPAWNING, RNG_DROPS, RNG_VFX };
+    uint32_t runSeed = std::random_device{}();
+    Rng spawnRng{ runSeed, RNG_SPAWNING };
+    Rng dropRng{ runSeed, RNG_DROPS };
+
+    void seedRandom(uint32_t seed) {
+        runSeed = seed;
+        spawnRng.Seed(seed, RNG_SPAWNING);
+        dropRng.Seed(seed, RNG_DROPS);
+    }
 
     // --- Difficulty System ---
     Difficulty difficulty = Difficulty::NORMAL;
@@ -305,10 +560,14 @@ public:
         shakeTimer = duration;
     }
 
-    olc::vf2d getShakeOffset() {
+    // Seeded from the level clock rather than drawn from a running stream, so a
+    // tick shakes the same way whichever frames before it were rendered
+    olc::vf2d getShakeOffset() const {
         if (shakeTimer <= 0.0f) return { 0.0f, 0.0f };
-        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
-        return { dist(rng) * shakeIntensity, dist(rng) * shakeIntensity };
+        uint32_t timeBits;
+        std::memcpy(&timeBits, &levelTime, sizeof(timeBits));
+        Rng shake{ (uint64_t(runSeed) << 32) | timeBits, RNG_VFX };
+        return { shake.Range(-1.0f, 1.0f) * shakeIntensity, shake.Range(-1.0f, 1.0f) * shakeIntensity };
     }
 
     // --- Active Power-Up Timers ---
@@ -334,6 +593,7 @@ public:
 
     // Returns true if player wants to advance to next slide
     bool renderStorySlide(olc::Decal* decal, const std::string& text, StoryMood mood, float dt) {
+        AllocTracker::Scope tagged("renderStorySlide");
         const float FADE_DURATION = 0.5f;
         const float AUTO_ADVANCE_TIME = 8.0f;
         const float TYPEWRITER_SPEED = 40.0f;  // chars per second
@@ -459,58 +719,15 @@ public:
         return advance;
     }
 
-    void startStoryMusic(StoryMood mood) {
-        // Don't restart if already playing
-        if (storyMusicPlaying) return;
-        
-        // Stop any current story music
-        stopStoryMusic();
-
-        // Play appropriate music with volume
-        int soundToPlay = -1;
+    // The looping story track for a slide mood; -1 if it failed to load
+    int storyTrack(StoryMood mood) const {
         switch (mood) {
-            case StoryMood::SAD:
-                soundToPlay = sndStorySad;
-                break;
-            case StoryMood::TRIUMPHANT:
-                soundToPlay = sndStoryTriumph;
-                break;
-            default:
-                soundToPlay = sndStoryEpic;
-        }
-
-        if (soundToPlay != -1) {
-            // Play with looping enabled and set volume
-            audio.SetVolume(soundToPlay, 0.6f);
-            audio.Play(soundToPlay, true); 
-            currentStoryMusic = soundToPlay;
-            storyMusicPlaying = true;
-            std::cout << "Playing story music: " << soundToPlay << std::endl;
-        } else {
-            std::cout << "Story music not loaded!" << std::endl;
+            case StoryMood::SAD:        return sndStorySad;
+            case StoryMood::TRIUMPHANT: return sndStoryTriumph;
+            default:                    return sndStoryEpic;
         }
     }
 
-    void stopStoryMusic() {
-        if (currentStoryMusic != -1) {
-            // First pause, then stop to ensure it really stops
-            audio.Pause(currentStoryMusic);
-            audio.Stop(currentStoryMusic);
-            std::cout << "Stopped story music ID: " << currentStoryMusic << std::endl;
-            currentStoryMusic = -1;
-            storyMusicPlaying = false;
-        }
-    }
-    
-    // Force stop ALL story music (call when entering gameplay)
-    void forceStopAllStoryMusic() {
-        if (sndStoryEpic != -1) audio.Stop(sndStoryEpic);
-        if (sndStorySad != -1) audio.Stop(sndStorySad);
-        if (sndStoryTriumph != -1) audio.Stop(sndStoryTriumph);
-        currentStoryMusic = -1;
-        storyMusicPlaying = false;
-    }
-
     // Timer & Level
     GameState state = GameState::MENU;
     int currentLevel = 0;
@@ -541,6 +758,20 @@ public:
     // High Score System
     int highScore = 0;
     const std::string HIGH_SCORE_FILE = "highscore.txt";
+    bool saveHighScores = true;  // Off for simulated runs, so a bot never overwrites a player's record
+
+    // --- Replays ---
+    // While recording or playing back, gameplay steps in fixed ticks of the replay's dt,
+    // each driven by one input bitmask, so the run can be rebuilt exactly from its seed
+    Replay replay;
+    std::string replayRecordPath;       // STARFALL_RECORD, overwritten by each game
+    bool replayRecording = false;
+    bool replayPlaying = false;         // STARFALL_REPLAY, played back by the next game started
+    bool runActive = false;
+    std::vector<uint8_t> bossCheckpoint;    // World as level 3 began, for "retry the boss"
+    size_t replayTick = 0;
+    float replayAccumulator = 0.0f;
+    olc::vf2d replayDirection;
 
     // ============================================================================
     // HIGH SCORE FUNCTIONS
@@ -559,7 +790,7 @@ public:
     }
 
     void saveHighScore() {
-        if (score > highScore) {
+        if (saveHighScores && score > highScore) {
             highScore = score;
             std::ofstream file(HIGH_SCORE_FILE);
             if (file.is_open()) {
@@ -571,17 +802,18 @@ public:
     }
 
     // ============================================================================
-    // HELPER: Load sprite with validation
+    // HELPER: Load sprites as one batch, with validation
     // ============================================================================
-    bool loadSprite(olc::Sprite*& spr, olc::Decal*& dec, const std::string& path) {
-        spr = new olc::Sprite(path);
-        if (spr->width == 0 || spr->height == 0) {
-            std::cerr << "ERROR: Failed to load sprite: " << path << std::endl;
-            return false;
+    std::vector<AssetCache::SpriteHandle> loadSprites(const std::vector<std::string>& paths) {
+        std::vector<AssetCache::SpriteHandle> handles = assets.LoadSpriteBatch(paths);
+        for (size_t i = 0; i < paths.size(); i++) {
+            if (!handles[i]->valid) {
+                std::cerr << "ERROR: Failed to load sprite: " << paths[i] << std::endl;
+                continue;
+            }
+            std::cout << "Loaded: " << paths[i] << " (" << handles[i]->sprite->width << "x" << handles[i]->sprite->height << ")" << std::endl;
         }
-        dec = new olc::Decal(spr);
-        std::cout << "Loaded: " << path << " (" << spr->width << "x" << spr->height << ")" << std::endl;
-        return true;
+        return handles;
     }
 
     // ============================================================================
@@ -598,21 +830,20 @@ public:
         player.invincibleTimer = GameConfig::INVINCIBILITY_DURATION;
         
         // Play player hit sound
-        playSound(sndPlayerHit, 0.7f);
+        playSoundFrom(sndPlayerHit, EMITTER_PLAYER, 0.7f);
         
         // Trigger screen shake on hit
         triggerScreenShake(GameConfig::SHAKE_INTENSITY_MEDIUM, GameConfig::SHAKE_DURATION_MEDIUM);
 
         if (player.lives <= 0) {
-            spawnExplosion(player.pos, decBoomShip, GameConfig::EXPLOSION_SHIP_DURATION,
-                (player.r * 2.0f) / sprBoomShip->width);
+            spawnExplosion(player.pos, dec(SpriteId::BOOM_SHIP), GameConfig::EXPLOSION_SHIP_DURATION,
+                (player.r * 2.0f) / spr(SpriteId::BOOM_SHIP)->width);
             triggerScreenShake(GameConfig::SHAKE_INTENSITY_LARGE, GameConfig::SHAKE_DURATION_MEDIUM);
             playSound(sndGameOver, 1.0f);
             // Go to Game Over Story instead of directly to Game Over
             state = GameState::STORY_GAMEOVER;
             storyGOIndex = 0;
             resetStorySlideState();
-            storyMusicPlaying = false;
             wins = false;
             saveHighScore();
         }
@@ -622,13 +853,12 @@ public:
     // POWER-UP SYSTEM
     // ============================================================================
     void spawnPowerUp(const olc::vf2d& pos) {
+        AllocTracker::Scope tagged("spawnPowerUp");
         // Random chance to spawn
-        std::uniform_real_distribution<float> chanceDist(0.0f, 1.0f);
-        if (chanceDist(rng) > GameConfig::POWERUP_SPAWN_CHANCE) return;
+        if (!dropRng.Chance(GameConfig::POWERUP_SPAWN_CHANCE)) return;
 
         // Random power-up type
-        std::uniform_int_distribution<int> typeDist(0, 3);
-        PowerUpType type = static_cast<PowerUpType>(typeDist(rng));
+        PowerUpType type = static_cast<PowerUpType>(dropRng.Int(0, 3));
 
         PowerUp p;
         p.pos = pos;
@@ -672,44 +902,44 @@ public:
     }
 
     void spawnEnemy() {
-        std::uniform_real_distribution<float> xDist(40.0f, float(ScreenWidth() - 40.0f));
-        std::uniform_real_distribution<float> vyDist(80.0f, 130.0f);
-        std::uniform_real_distribution<float> vxDist(-40.0f, 40.0f);
+        AllocTracker::Scope tagged("spawnEnemy");
+        float u[3];     // x, vx, vy
+        spawnRng.FillUniform(u, 3);
 
         Enemy e;
-        e.pos = { xDist(rng), -40.0f };
-        e.vel = { vxDist(rng), vyDist(rng) };
+        e.pos = { Rng::Lerp(40.0f, float(ScreenWidth() - 40.0f), u[0]), -40.0f };
+        e.vel = { Rng::Lerp(-40.0f, 40.0f, u[1]), Rng::Lerp(80.0f, 130.0f, u[2]) };
         e.r = 20.0f;
         e.alive = true;
         e.inArena = false;
-        e.decal = decEnemy;
+        e.decal = dec(SpriteId::ENEMY);
 
         enemies.push_back(e);
     }
 
     void spawnAsteroid() {
-        std::uniform_real_distribution<float> xDist(10.0f, float(ScreenWidth()) - 10.0f);
-        std::uniform_real_distribution<float> vyDist(80.0f, 150.0f);
-        std::uniform_real_distribution<float> vxDist(-20.0f, 20.0f);
-        std::uniform_real_distribution<float> rDist(24.0f, 40.0f);
+        AllocTracker::Scope tagged("spawnAsteroid");
+        float u[4];     // x, vx, vy, radius
+        spawnRng.FillUniform(u, 4);
 
         Asteroid a;
-        a.pos = { xDist(rng), -30.0f };
-        a.vel = { vxDist(rng), vyDist(rng) };
-        a.r = rDist(rng);
+        a.pos = { Rng::Lerp(10.0f, float(ScreenWidth()) - 10.0f, u[0]), -30.0f };
+        a.vel = { Rng::Lerp(-20.0f, 20.0f, u[1]), Rng::Lerp(80.0f, 150.0f, u[2]) };
+        a.r = Rng::Lerp(24.0f, 40.0f, u[3]);
         a.alive = true;
-        a.decal = decAsteroid;
+        a.decal = dec(SpriteId::ASTEROID);
 
         asteroids.push_back(a);
     }
 
     void spawnBullet(const olc::vf2d& startpos) {
+        AllocTracker::Scope tagged("spawnBullet");
         Bullet b;
         b.pos = startpos;
         b.vel = { 0.0f, -GameConfig::PLAYER_BULLET_SPEED };
         b.r = 4.0f;
         b.alive = true;
-        b.decal = decBullet;
+        b.decal = dec(SpriteId::BULLET);
 
         bullets.push_back(b);
     }
@@ -726,16 +956,18 @@ public:
             spawnBullet(basePos);
         }
         
-        playSound(sndShoot, 0.3f);  // Lower volume for frequent shooting
+        int shot = sfxBank.Variation("shoot");
+        playSoundFrom(shot >= 0 ? shot : sndShoot, EMITTER_PLAYER, 0.3f);  // Lower volume for frequent shooting
     }
 
     void spawnEnemyBullet(const olc::vf2d& startPos) {
+        AllocTracker::Scope tagged("spawnEnemyBullet");
         EnemyBullet eb;
         eb.pos = startPos;
         eb.vel = { 0.0f, 220.0f };
         eb.r = 4.0f;
         eb.alive = true;
-        eb.decal = decBullet;
+        eb.decal = dec(SpriteId::BULLET);
         enemyBullets.push_back(eb);
     }
 
@@ -750,7 +982,7 @@ public:
         bl.vel = { 0.0f, 260.0f };
         bl.r = 4.0f;
         bl.alive = true;
-        bl.decal = decBullet;
+        bl.decal = dec(SpriteId::BULLET);
 
         EnemyBullet br = bl;
         br.pos = rightmuzz;
@@ -760,6 +992,7 @@ public:
     }
 
     void spawnExplosion(const olc::vf2d& pos, olc::Decal* decal, float maxTime, float scale = 1.0f) {
+        AllocTracker::Scope tagged("spawnExplosion");
         Explosion e;
         e.pos = pos;
         e.decal = decal;
@@ -772,6 +1005,8 @@ public:
     bool OnUserCreate() override
     {
         std::cout << "=== Operation Starfall Initializing ===" << std::endl;
+        Trace::SetThreadName("engine");
+        assets.SetProfiler(&startup);
 
         // Reserve vector capacity for performance
         bullets.reserve(GameConfig::RESERVE_BULLETS);
@@ -781,150 +1016,142 @@ public:
         explosions.reserve(GameConfig::RESERVE_EXPLOSIONS);
         powerups.reserve(GameConfig::RESERVE_POWERUPS);
 
-        // Load all sprites with validation
-      // Load Sprites
-    auto loadSprite = [&](std::string path) {
-        olc::Sprite* s = new olc::Sprite(path);
-        if (s->width == 0) {
-            std::cout << "Failed to load: " << path << std::endl;
-        }
-        return s;
-    };
-
-    sprBackground = loadSprite("assets/sprites/bg_space.png");
-    sprPlayer = loadSprite("assets/sprites/player_ship.png");
-    sprAsteroid = loadSprite("assets/sprites/asteroid.png");
-    sprBullet = loadSprite("assets/sprites/bullet.png");
-    sprEnemy = loadSprite("assets/sprites/enemy_ship.png");
-    sprEnemyBullet = loadSprite("assets/sprites/bullet.png");  // Reuse bullet sprite
-    sprBoomAsteroid = loadSprite("assets/sprites/boom_asteroid.png");
-    sprBoomShip = loadSprite("assets/sprites/boom_ship.png");
-    sprBoss = loadSprite("assets/sprites/boss_ship.png");
-
-    decBackground = new olc::Decal(sprBackground);
-    decPlayer = new olc::Decal(sprPlayer);
-    decAsteroid = new olc::Decal(sprAsteroid);
-    decBullet = new olc::Decal(sprBullet);
-    decEnemy = new olc::Decal(sprEnemy);
-    decEnemyBullet = new olc::Decal(sprEnemyBullet);
-    decBoomAsteroid = new olc::Decal(sprBoomAsteroid);
-    decBoomShip = new olc::Decal(sprBoomShip);
-    decBoss = new olc::Decal(sprBoss);
-
-    // Load Story Sprites
-    std::string storyFiles[] = {
-        "assets/sprites/story_1.jpg",
-        "assets/sprites/story_2.jpg",
-        "assets/sprites/story_3.jpg",
-        "assets/sprites/story_4.png",
-        "assets/sprites/story_5.png"
-    };
-
-    for (const auto& file : storyFiles) {
-        olc::Sprite* s = loadSprite(file);
-        storySprites.push_back(s);
-        storyDecals.push_back(new olc::Decal(s));
-    }
-
-    // Story Text
-    storyText = {
-        "The Alien threat began with a calculated gaze upon Earth...\nTarget: Dhaka.",
-        "Our Satellite 'Bangabandhu Deep Space Sentinel-1'\ndetected the incoming invasion fleet.",
-        "Emergency Protocol Initiated.\nWorld Leaders gathered to formulate a pre-emptive strike.",
-        "Operation Starfall Launch Initiated.\nThe Bangladesh Space Force deploys the flagship.",
-        "Battle Stations!\nOur forces engage the enemy to defend our home!"
-    };
-
-    // Load Level 2 Story Sprites
-    std::string storyL2Files[] = {
-        "assets/sprites/story_lvl2_1.jpg",
-        "assets/sprites/story_lvl2_2.jpg",
-        "assets/sprites/story_lvl2_3.png"
-    };
-
-    for (const auto& file : storyL2Files) {
-        olc::Sprite* s = loadSprite(file);
-        storyL2Sprites.push_back(s);
-        storyL2Decals.push_back(new olc::Decal(s));
-    }
-
-    // Level 2 Story Text
-    storyL2Text = {
-        "The Aliens are losing patience!\nTheir commander orders the swarm to attack!",
-        "Humanity fights back!\nOur pilots regroup for the counter-offensive.",
-        "Dogfight in Deep Space!\nEngaging enemy fighter squadrons."
-    };
-
-    // Load Level 3 Story Sprites
-    std::string storyL3Files[] = {
-        "assets/sprites/story_lvl3_1.png",
-        "assets/sprites/story_lvl3_2.png",
-        "assets/sprites/story_lvl3_3.jpg"
-    };
-
-    for (const auto& file : storyL3Files) {
-        olc::Sprite* s = loadSprite(file);
-        storyL3Sprites.push_back(s);
-        storyL3Decals.push_back(new olc::Decal(s));
-    }
-
-    // Level 3 Story Text
-    storyL3Text = {
-        "The Alien Queen is furious at her fleet's failure!\nShe commands the mothership to engage.",
-        "Warning: Massive Energy Signature Detected!\nThe Boss Ship is approaching.",
-        "The Final Battle Begins!\nDefend Earth at all costs!"
-    };
-
-    // Load Game Over Story Sprites
-    std::string storyGOFiles[] = {
-        "assets/sprites/story_gameover_1.jpg",
-        "assets/sprites/story_gameover_2.jpg",
-        "assets/sprites/story_gameover_3.jpg"
-    };
-
-    for (const auto& file : storyGOFiles) {
-        olc::Sprite* s = loadSprite(file);
-        storyGOSprites.push_back(s);
-        storyGODecals.push_back(new olc::Decal(s));
-    }
-
-    // Game Over Story Text
-    storyGOText = {
-        "Our flagship is destroyed!\nThe alien fleet overwhelms our defenses.",
-        "With no one left to stop them...\nThe aliens unleash their fury upon Earth.",
-        "Earth falls silent...\nHumanity's last hope is gone."
-    };
-
-    // Load Victory Story Sprites
-    std::string storyVictoryFiles[] = {
-        "assets/sprites/story_victory_1.jpg",
-        "assets/sprites/story_victory_2.jpg",
-        "assets/sprites/story_victory_3.jpg",
-        "assets/sprites/story_victory_4.jpg"
-    };
-
-    for (const auto& file : storyVictoryFiles) {
-        olc::Sprite* s = loadSprite(file);
-        storyVictorySprites.push_back(s);
-        storyVictoryDecals.push_back(new olc::Decal(s));
-    }
-
-    // Victory Story Text
-    storyVictoryText = {
-        "The Alien Mothership is destroyed!\nHumanity's counterattack succeeds!",
-        "Our forces push forward and obliterate\nthe alien homeworld!",
-        "Our heroes return home to a hero's welcome.\nLeaders embrace the saviors of Earth!",
-        "The people of Earth celebrate VICTORY!\nBangladesh leads the way to peace!"
-    };
+        // Every sprite is decoded, then uploaded, as one batch through the asset cache.
+        // Gameplay sprites come first, in SpriteId order.
+        std::vector<std::string> spriteFiles = {
+            "assets/sprites/bg_space.png",
+            "assets/sprites/player_ship.png",
+            "assets/sprites/asteroid.png",
+            "assets/sprites/enemy_ship.png",
+            "assets/sprites/boss_ship.png",
+            "assets/sprites/bullet.png",
+            "assets/sprites/bullet.png",  // Enemy bullets reuse the bullet sprite
+            "assets/sprites/boom_asteroid.png",
+            "assets/sprites/boom_ship.png"
+        };
+
+        // Story slides follow, one group per sequence
+        const std::vector<std::string> storyFiles = {
+            "assets/sprites/story_1.jpg",
+            "assets/sprites/story_2.jpg",
+            "assets/sprites/story_3.jpg",
+            "assets/sprites/story_4.png",
+            "assets/sprites/story_5.png"
+        };
+        const std::vector<std::string> storyL2Files = {
+            "assets/sprites/story_lvl2_1.jpg",
+            "assets/sprites/story_lvl2_2.jpg",
+            "assets/sprites/story_lvl2_3.png"
+        };
+        const std::vector<std::string> storyL3Files = {
+            "assets/sprites/story_lvl3_1.png",
+            "assets/sprites/story_lvl3_2.png",
+            "assets/sprites/story_lvl3_3.jpg"
+        };
+        const std::vector<std::string> storyGOFiles = {
+            "assets/sprites/story_gameover_1.jpg",
+            "assets/sprites/story_gameover_2.jpg",
+            "assets/sprites/story_gameover_3.jpg"
+        };
+        const std::vector<std::string> storyVictoryFiles = {
+            "assets/sprites/story_victory_1.jpg",
+            "assets/sprites/story_victory_2.jpg",
+            "assets/sprites/story_victory_3.jpg",
+            "assets/sprites/story_victory_4.jpg"
+        };
+        for (const auto* files : { &storyFiles, &storyL2Files, &storyL3Files, &storyGOFiles, &storyVictoryFiles })
+            spriteFiles.insert(spriteFiles.end(), files->begin(), files->end());
+
+        std::vector<AssetCache::SpriteHandle> loaded = loadSprites(spriteFiles);
+        auto next = loaded.begin();
+        for (auto& handle : sprites) handle = *next++;
+        auto takeSlides = [&](std::vector<AssetCache::SpriteHandle>& slides, size_t count) {
+            slides.assign(next, next + count);
+            next += count;
+        };
+        takeSlides(storySlides, storyFiles.size());
+        takeSlides(storyL2Slides, storyL2Files.size());
+        takeSlides(storyL3Slides, storyL3Files.size());
+        takeSlides(storyGOSlides, storyGOFiles.size());
+        takeSlides(storyVictorySlides, storyVictoryFiles.size());
+
+        // Story Text
+        storyText = {
+            "The Alien threat began with a calculated gaze upon Earth...\nTarget: Dhaka.",
+            "Our Satellite 'Bangabandhu Deep Space Sentinel-1'\ndetected the incoming invasion fleet.",
+            "Emergency Protocol Initiated.\nWorld Leaders gathered to formulate a pre-emptive strike.",
+            "Operation Starfall Launch Initiated.\nThe Bangladesh Space Force deploys the flagship.",
+            "Battle Stations!\nOur forces engage the enemy to defend our home!"
+        };
+
+        // Level 2 Story Text
+        storyL2Text = {
+            "The Aliens are losing patience!\nTheir commander orders the swarm to attack!",
+            "Humanity fights back!\nOur pilots regroup for the counter-offensive.",
+            "Dogfight in Deep Space!\nEngaging enemy fighter squadrons."
+        };
+
+        // Level 3 Story Text
+        storyL3Text = {
+            "The Alien Queen is furious at her fleet's failure!\nShe commands the mothership to engage.",
+            "Warning: Massive Energy Signature Detected!\nThe Boss Ship is approaching.",
+            "The Final Battle Begins!\nDefend Earth at all costs!"
+        };
+
+        // Game Over Story Text
+        storyGOText = {
+            "Our flagship is destroyed!\nThe alien fleet overwhelms our defenses.",
+            "With no one left to stop them...\nThe aliens unleash their fury upon Earth.",
+            "Earth falls silent...\nHumanity's last hope is gone."
+        };
+
+        // Victory Story Text
+        storyVictoryText = {
+            "The Alien Mothership is destroyed!\nHumanity's counterattack succeeds!",
+            "Our forces push forward and obliterate\nthe alien homeworld!",
+            "Our heroes return home to a hero's welcome.\nLeaders embrace the saviors of Earth!",
+            "The people of Earth celebrate VICTORY!\nBangladesh leads the way to peace!"
+        };
 
         // Load high score
-        loadHighScore();
+        {
+            StartupProfiler::Scope timer(startup, "high score load");
+            loadHighScore();
+        }
 
         // Initialize audio system
         loadAudioFiles();
 
+        assets.PrintReport();
+        assets.SetProfiler(nullptr);
+
         std::cout << "=== All assets loaded successfully! ===" << std::endl;
 
+        finishStartupProfile();
+        if (startupOverBudget) {
+            std::cerr << "ERROR: Startup exceeded its time budget" << std::endl;
+            return false;
+        }
+
+        if (GameConfig::HOT_RELOAD_ASSETS) {
+            hotReload.Start(GameConfig::HOT_RELOAD_DIR);
+        }
+
+        if (const char* path = std::getenv("STARFALL_REPLAY")) {
+            replayPlaying = replay.Load(path);
+            if (replayPlaying && replay.GetHeader().level != 1) {
+                std::cerr << "ERROR: Replay starts on level " << int(replay.GetHeader().level) << ", only the simulator can play it back" << std::endl;
+                replayPlaying = false;
+            }
+            if (replayPlaying) {
+                std::cout << "Replay loaded: " << path << " (" << replay.GetTickCount() << " ticks), start a game to watch it" << std::endl;
+            }
+        }
+        else if (const char* path = std::getenv("STARFALL_RECORD")) {
+            replayRecordPath = path;
+            replayRecording = true;
+        }
+
         state = GameState::MENU;
         return true;
     }
@@ -955,6 +1182,7 @@ public:
         boss.hp = boss.maxHp;
         wins = false;
         boss.alive = false;
+        bossCheckpoint.clear();
 
         startLevel(1);
     }
@@ -985,19 +1213,313 @@ public:
             enemySpawnRate = 2.5f;
 
             boss.Reset({ ScreenWidth() / 2.0f, -60.0f });
-            boss.decal = decBoss;
+            boss.decal = dec(SpriteId::BOSS);
 
             bossFireCooldown = 1.2f;
             bossFireTimer = 1.0f;
         }
 
-        player.decal = decPlayer;
+        player.decal = dec(SpriteId::PLAYER);
         player.Reset({ ScreenWidth() / 2.0f, ScreenHeight() - 60.0f });
+
+        // Losing to the boss can restart the fight from here
+        if (currentLevel == 3) bossCheckpoint = saveSnapshot();
+    }
+
+    // Moves on to the next story/level once the current level's objective is met
+    void checkLevelComplete() {
+        if (player.lives > 0) {
+            if (currentLevel == 1) {
+                if (levelTime >= GameConfig::LEVEL1_DURATION) {
+                    playSound(sndLevelComplete, 1.0f);
+                    // Go to Level 2 Story instead of directly to Level 2
+                    state = GameState::STORY_LEVEL2;
+                    storyL2Index = 0;
+                    resetStorySlideState();
+                }
+            }
+            else if (currentLevel == 2) {
+                if (enemiesKilled >= GameConfig::LEVEL2_KILL_TARGET) {
+                    playSound(sndLevelComplete, 1.0f);
+                    // Go to Level 3 Story instead of direct Level 3
+                    state = GameState::STORY_LEVEL3;
+                    storyL3Index = 0;
+                    resetStorySlideState();
+                }
+            }
+            else if (currentLevel == 3) {
+                if (!boss.alive) {
+                    playSound(sndLevelComplete, 1.0f);  // Victory!
+                    // Go to Victory Story instead of directly to Game Over
+                    state = GameState::STORY_VICTORY;
+                    storyVictoryIndex = 0;
+                    resetStorySlideState();
+                    wins = true;
+                    saveHighScore();
+                }
+            }
+        }
+    }
+
+    // ============================================================================
+    // RUNS & REPLAYS
+    // ============================================================================
+    // A new game from the menu. Reseeds and resets everything, so a recorded run
+    // can be rebuilt from nothing but its header and inputs
+    void beginRun() {
+        Replay::Header header;
+        if (replayPlaying) {
+            header = replay.GetHeader();
+            difficulty = static_cast<Difficulty>(header.difficulty);
+        }
+        else {
+            header.seed = std::random_device{}();
+            header.difficulty = uint8_t(difficulty);
+            header.dt = GameConfig::REPLAY_DT;
+        }
+
+        seedRandom(header.seed);
+        ResetGame();
+        replayTick = 0;
+        replayAccumulator = 0.0f;
+        runActive = true;
+        if (replayRecording) replay.Begin(header);
+    }
+
+    // The game was won, lost or quit: save the recording, or check the playback stayed in sync
+    void finishRun() {
+        if (!runActive) return;
+        runActive = false;
+        player.inputOverride = nullptr;
+
+        if (replayRecording) {
+            replay.GetHeader().stateHash = stateHash();
+            if (replay.Save(replayRecordPath)) {
+                std::cout << "Replay saved: " << replayRecordPath << " (" << replay.GetTickCount() << " ticks)" << std::endl;
+            }
+        }
+        if (replayPlaying) {
+            uint64_t expected = replay.GetHeader().stateHash;
+            if (expected != 0 && expected != stateHash()) {
+                std::cerr << "ERROR: Replay desynced, the final state differs from the recording" << std::endl;
+            }
+            else {
+                std::cout << "Replay finished after " << replayTick << " ticks" << std::endl;
+            }
+            replayPlaying = false;
+        }
+    }
+
+    // Fingerprint of the gameplay state, compared at the end of a replay
+    uint64_t stateHash() const {
+        uint64_t hash = Replay::Hash(&score, sizeof(score));
+        auto mix = [&](const auto& value) { hash = Replay::Hash(&value, sizeof(value), hash); };
+
+        mix(hits);
+        mix(player.lives);
+        mix(player.pos.x);
+        mix(player.pos.y);
+        mix(currentLevel);
+        mix(enemiesKilled);
+        mix(boss.hp);
+        for (const auto& a : asteroids) { mix(a.pos.x); mix(a.pos.y); }
+        for (const auto& e : enemies) { mix(e.pos.x); mix(e.pos.y); }
+        for (const auto& b : bullets) { mix(b.pos.x); mix(b.pos.y); }
+        for (const auto& eb : enemyBullets) { mix(eb.pos.x); mix(eb.pos.y); }
+        return hash;
+    }
+
+    uint8_t keyboardInput() {
+        olc::vf2d dir = { 0.0f, 0.0f };
+        if (GetKey(olc::Key::LEFT).bHeld || GetKey(olc::Key::A).bHeld) dir.x -= 1.0f;
+        if (GetKey(olc::Key::RIGHT).bHeld || GetKey(olc::Key::D).bHeld) dir.x += 1.0f;
+        if (GetKey(olc::Key::UP).bHeld || GetKey(olc::Key::W).bHeld) dir.y -= 1.0f;
+        if (GetKey(olc::Key::DOWN).bHeld || GetKey(olc::Key::S).bHeld) dir.y += 1.0f;
+        return Replay::FromDirection(dir);
+    }
+
+    // ============================================================================
+    // WORLD SNAPSHOTS
+    // ============================================================================
+    // Everything updateCurrentLevel reads or writes, RNG streams included, so a
+    // restored world carries on exactly as the original did from the same inputs
+    std::vector<uint8_t> saveSnapshot() const {
+        std::vector<uint8_t> data;
+        data.reserve(256 + 32 * (asteroids.size() + bullets.size() + enemies.size()
+            + enemyBullets.size() + powerups.size() + explosions.size()));
+        SnapshotWriter out(data);
+
+        out.Write(state);
+        out.Write(difficulty);
+        out.Write(currentLevel);
+        out.Write(levelTime);
+        out.Write(spawnTimer);
+        out.Write(spawnRate);
+        out.Write(fireCoolDown);
+        out.Write(fireTimer);
+        out.Write(enemySpawnTimer);
+        out.Write(enemySpawnRate);
+        out.Write(maxEnemies);
+        out.Write(enemyFireTimer);
+        out.Write(enemyFireCooldown);
+        out.Write(bossFireTimer);
+        out.Write(bossFireCooldown);
+        out.Write(score);
+        out.Write(hits);
+        out.Write(wins);
+        out.Write(enemiesKilled);
+        out.Write(total_enemy_spawn);
+        out.Write(doubleShotTimer);
+        out.Write(speedBoostTimer);
+        out.Write(shieldTimer);
+        out.Write(shakeTimer);
+        out.Write(shakeIntensity);
+        out.Write(bgOffset);
+        out.Write(runSeed);
+        out.Write(spawnRng);
+        out.Write(dropRng);
+        out.Write(uint64_t(replayTick));
+
+        player.Save(out);
+        boss.Save(out);
+        out.WriteVector(asteroids);
+        out.WriteVector(bullets);
+        out.WriteVector(enemies);
+        out.WriteVector(enemyBullets);
+        out.WriteVector(powerups);
+        out.Write(uint32_t(explosions.size()));
+        for (const auto& e : explosions) {
+            out.Write(e.decal == dec(SpriteId::BOOM_SHIP));
+            e.Save(out);
+        }
+
+        out.Finish();
+        return data;
+    }
+
+    // Puts the world back as saveSnapshot found it. A blob from another build version
+    // (or a damaged one) is rejected, leaving a fresh game instead of a half restored one
+    bool restoreSnapshot(const std::vector<uint8_t>& data) {
+        SnapshotReader in(data.data(), data.size());
+        uint64_t tick = 0;
+        uint32_t explosionCount = 0;
+        GameState savedState = state;
+        Difficulty savedDifficulty = difficulty;
+
+        in.Read(savedState);
+        in.Read(savedDifficulty);
+        in.Read(currentLevel);
+        in.Read(levelTime);
+        in.Read(spawnTimer);
+        in.Read(spawnRate);
+        in.Read(fireCoolDown);
+        in.Read(fireTimer);
+        in.Read(enemySpawnTimer);
+        in.Read(enemySpawnRate);
+        in.Read(maxEnemies);
+        in.Read(enemyFireTimer);
+        in.Read(enemyFireCooldown);
+        in.Read(bossFireTimer);
+        in.Read(bossFireCooldown);
+        in.Read(score);
+        in.Read(hits);
+        in.Read(wins);
+        in.Read(enemiesKilled);
+        in.Read(total_enemy_spawn);
+        in.Read(doubleShotTimer);
+        in.Read(speedBoostTimer);
+        in.Read(shieldTimer);
+        in.Read(shakeTimer);
+        in.Read(shakeIntensity);
+        in.Read(bgOffset);
+        in.Read(runSeed);
+        in.Read(spawnRng);
+        in.Read(dropRng);
+        in.Read(tick);
+        replayTick = size_t(tick);
+
+        player.Load(in);
+        boss.Load(in);
+        in.ReadVector(asteroids);
+        in.ReadVector(bullets);
+        in.ReadVector(enemies);
+        in.ReadVector(enemyBullets);
+        in.ReadVector(powerups);
+        if (in.Read(explosionCount) && explosionCount <= data.size()) {
+            explosions.resize(explosionCount);
+            for (auto& e : explosions) {
+                bool ship = false;
+                in.Read(ship);
+                e.Load(in);
+                e.decal = dec(ship ? SpriteId::BOOM_SHIP : SpriteId::BOOM_ASTEROID);
+            }
+        }
+
+        // An enum out of range means the bytes aren't a world this build wrote
+        bool inRange = int(savedState) >= 0 && savedState <= GameState::PAUSED
+            && int(savedDifficulty) >= 0 && savedDifficulty <= Difficulty::HARD;
+        if (!in.Done() || !inRange) {
+            std::cerr << "ERROR: Could not restore snapshot (" << data.size() << " bytes)" << std::endl;
+            ResetGame();
+            return false;
+        }
+        state = savedState;
+        difficulty = savedDifficulty;
+
+        // Pointers never go into a snapshot, so every decal is linked up again here
+        player.decal = dec(SpriteId::PLAYER);
+        boss.decal = dec(SpriteId::BOSS);
+        for (auto& a : asteroids) a.decal = dec(SpriteId::ASTEROID);
+        for (auto& e : enemies) e.decal = dec(SpriteId::ENEMY);
+        for (auto& b : bullets) b.decal = dec(SpriteId::BULLET);
+        for (auto& eb : enemyBullets) eb.decal = dec(SpriteId::BULLET);
+        return true;
+    }
+
+    // This frame's gameplay: one update of dt normally, or as many fixed replay ticks as dt covers
+    void stepGameplay(float dt) {
+        if (!runActive || (!replayRecording && !replayPlaying)) {
+            updateCurrentLevel(dt);
+            checkLevelComplete();
+            return;
+        }
+
+        const float tickDt = replay.GetHeader().dt;
+        replayAccumulator = std::min(replayAccumulator + dt, tickDt * GameConfig::REPLAY_MAX_TICKS_PER_FRAME);
+        player.inputOverride = &replayDirection;
+
+        while (replayAccumulator >= tickDt && state == GameState::PLAYING) {
+            replayAccumulator -= tickDt;
+            if (replayPlaying && replayTick >= replay.GetTickCount()) {
+                // The recording was quit part way through
+                finishRun();
+                state = GameState::MENU;
+                return;
+            }
+
+            uint8_t input = replayPlaying ? replay.Input(replayTick) : keyboardInput();
+            if (replayRecording) replay.Record(input);
+            replayDirection = Replay::ToDirection(input);
+
+            updateCurrentLevel(tickDt);
+            checkLevelComplete();
+            replayTick++;
+        }
+
+        player.inputOverride = nullptr;
+        if (state == GameState::STORY_VICTORY || state == GameState::STORY_GAMEOVER) finishRun();
     }
 
     void updateCurrentLevel(float dt) {
+        FrameProfiler::Scope phase(profiler, FramePhase::INTEGRATE);
+        AllocTracker::Scope tagged("updateCurrentLevel");
         levelTime += dt;
 
+        // The background scrolls with the simulation, so a replayed or simulated tick renders the same frame
+        bgOffset += 40.0f * dt;
+        if (bgOffset >= spr(SpriteId::BACKGROUND)->height)
+            bgOffset -= spr(SpriteId::BACKGROUND)->height;
+
         // Update power-up and shake timers
         updatePowerUpTimers(dt);
 
@@ -1012,6 +1534,7 @@ public:
         player.speed = originalSpeed; // Restore
 
         // Auto-shooting (now uses spawnPlayerBullets for double shot)
+        phase.Switch(FramePhase::SPAWN);
         fireTimer -= dt;
         if (fireTimer <= 0.0f) {
             spawnPlayerBullets();
@@ -1027,11 +1550,13 @@ public:
         }
 
         // Update power-ups
+        phase.Switch(FramePhase::INTEGRATE);
         for (auto& p : powerups) {
             if (p.alive) p.Update(dt, ScreenHeight());
         }
 
         // Spawn enemies (Level 2 and 3)
+        phase.Switch(FramePhase::SPAWN);
         if (currentLevel == 2 || currentLevel == 3) {
             enemySpawnTimer -= dt;
             if (enemySpawnTimer <= 0.0f) {
@@ -1053,6 +1578,7 @@ public:
         }
 
         // Update bullets
+        phase.Switch(FramePhase::INTEGRATE);
         for (auto& b : bullets) {
             if (b.alive) b.Update(dt);
         }
@@ -1068,6 +1594,7 @@ public:
         }
 
         // Enemy shooting
+        phase.Switch(FramePhase::SPAWN);
         if (currentLevel == 2 || currentLevel == 3) {
             enemyFireTimer -= dt;
             if (enemyFireTimer <= 0.0f) {
@@ -1081,6 +1608,7 @@ public:
         }
 
         // Update enemy bullets
+        phase.Switch(FramePhase::INTEGRATE);
         for (auto& eb : enemyBullets) {
             if (eb.alive) eb.Update(dt, ScreenHeight());
         }
@@ -1103,44 +1631,29 @@ public:
         }
 
         // ===== COLLISION DETECTION =====
+        phase.Switch(FramePhase::COLLIDE);
 
         // Asteroid vs bullets
-        for (auto& b : bullets) {
-            if (!b.alive) continue;
-            for (auto& a : asteroids) {
-                if (!a.alive) continue;
-                float hitR = b.r + a.r;
-                if (Dist2(b.pos, a.pos) <= hitR * hitR) {
-                    b.alive = false;
-                    spawnExplosion(a.pos, decBoomAsteroid, GameConfig::EXPLOSION_ASTEROID_DURATION, 
-                                   a.r * 2.0f / sprBoomAsteroid->width);
-                    a.alive = false;
-                    score += GameConfig::SCORE_ASTEROID;
-                    playSound(sndExplosionSmall, 0.4f);
-                    break;
-                }
-            }
-        }
+        CollideShots(bullets, asteroids, [this](Bullet& b, Asteroid& a) {
+            b.alive = false;
+            spawnExplosion(a.pos, dec(SpriteId::BOOM_ASTEROID), GameConfig::EXPLOSION_ASTEROID_DURATION, 
+                           a.r * 2.0f / spr(SpriteId::BOOM_ASTEROID)->width);
+            a.alive = false;
+            score += GameConfig::SCORE_ASTEROID;
+            playSoundAt(sndExplosionSmall, a.pos, 0.4f);
+        });
 
         // Enemy vs bullets
-        for (auto& b : bullets) {
-            if (!b.alive) continue;
-            for (auto& e : enemies) {
-                if (!e.alive) continue;
-                float hitR = b.r + e.r;
-                if (Dist2(b.pos, e.pos) <= hitR * hitR) {
-                    b.alive = false;
-                    e.alive = false;
-                    spawnExplosion(e.pos, decBoomShip, GameConfig::EXPLOSION_SHIP_DURATION, 
-                                   (e.r * 2.0f) / sprBoomShip->width);
-                    score += GameConfig::SCORE_ENEMY;
-                    enemiesKilled += 1;
-                    spawnPowerUp(e.pos);  // Chance to spawn power-up
-                    playSound(sndExplosionLarge, 0.6f);
-                    break;
-                }
-            }
-        }
+        CollideShots(bullets, enemies, [this](Bullet& b, Enemy& e) {
+            b.alive = false;
+            e.alive = false;
+            spawnExplosion(e.pos, dec(SpriteId::BOOM_SHIP), GameConfig::EXPLOSION_SHIP_DURATION, 
+                           (e.r * 2.0f) / spr(SpriteId::BOOM_SHIP)->width);
+            score += GameConfig::SCORE_ENEMY;
+            enemiesKilled += 1;
+            spawnPowerUp(e.pos);  // Chance to spawn power-up
+            playSoundAt(sndExplosionLarge, e.pos, 0.6f);
+        });
 
         // Power-up vs player
         for (auto& p : powerups) {
@@ -1158,8 +1671,8 @@ public:
             float hitR = a.r + player.r;
             if (Dist2(a.pos, player.pos) <= hitR * hitR) {
                 a.alive = false;
-                spawnExplosion(a.pos, decBoomAsteroid, GameConfig::EXPLOSION_ASTEROID_DURATION, 
-                               a.r * 2.0f / sprBoomAsteroid->width);
+                spawnExplosion(a.pos, dec(SpriteId::BOOM_ASTEROID), GameConfig::EXPLOSION_ASTEROID_DURATION, 
+                               a.r * 2.0f / spr(SpriteId::BOOM_ASTEROID)->width);
                 handlePlayerHit();
             }
         }
@@ -1170,8 +1683,8 @@ public:
             float hitR = e.r + player.r;
             if (Dist2(e.pos, player.pos) <= hitR * hitR) {
                 e.alive = false;
-                spawnExplosion(e.pos, decBoomShip, GameConfig::EXPLOSION_SHIP_DURATION, 
-                               (e.r * 2.0f) / sprBoomShip->width);
+                spawnExplosion(e.pos, dec(SpriteId::BOOM_SHIP), GameConfig::EXPLOSION_SHIP_DURATION, 
+                               (e.r * 2.0f) / spr(SpriteId::BOOM_SHIP)->width);
                 handlePlayerHit();
             }
         }
@@ -1196,15 +1709,15 @@ public:
                     boss.hp -= GameConfig::BOSS_DAMAGE_PER_HIT;
                     score += GameConfig::SCORE_BOSS_HIT;
                     triggerScreenShake(GameConfig::SHAKE_INTENSITY_SMALL, GameConfig::SHAKE_DURATION_SHORT);
-                    playSound(sndBossHit, 0.4f);
+                    playSoundFrom(sndBossHit, EMITTER_BOSS, 0.4f);
 
                     if (boss.hp <= 0) {
                         boss.hp = 0;
                         boss.alive = false;
-                        spawnExplosion(boss.pos, decBoomShip, GameConfig::EXPLOSION_SHIP_DURATION, 
-                                       (boss.r * 2.0f) / sprBoomShip->width);
+                        spawnExplosion(boss.pos, dec(SpriteId::BOOM_SHIP), GameConfig::EXPLOSION_SHIP_DURATION, 
+                                       (boss.r * 2.0f) / spr(SpriteId::BOOM_SHIP)->width);
                         triggerScreenShake(GameConfig::SHAKE_INTENSITY_LARGE, GameConfig::SHAKE_DURATION_MEDIUM);
-                        playSound(sndExplosionLarge, 1.0f);
+                        playSoundAt(sndExplosionLarge, boss.pos, 1.0f);
                     }
                     break;
                 }
@@ -1220,6 +1733,7 @@ public:
         }
 
         // Clean up dead objects
+        phase.Switch(FramePhase::CLEANUP);
         bullets.erase(
             std::remove_if(bullets.begin(), bullets.end(),
                 [](const Bullet& b) {return !b.alive; }),
@@ -1255,8 +1769,184 @@ public:
         );
     }
 
+    bool OnUserDestroy() override
+    {
+        finishRun();
+
+        std::string profilePath = GameConfig::FRAME_PROFILE_CSV;
+        if (const char* env = std::getenv("STARFALL_PROFILE_CSV")) profilePath = env;
+        if (!profilePath.empty()) profiler.WriteCsv(profilePath);
+        allocations.Report();
+
+        if (audioLoaded && audio.GetDeviceMode() != olc::MiniAudio::DeviceMode::Hardware) {
+            audio.StopRecording();
+            const auto render = audio.GetRenderStats();
+            std::cout << "Offline audio: " << render.m_frames << " frames mixed, peak " << render.m_peak
+                      << ", " << render.m_clipped_samples << " samples clipped" << std::endl;
+        }
+#ifdef _DEBUG
+        if (audioLoaded) {
+            printVoiceStats();
+            audioQueue.PrintStats();
+            const auto latency = audio.GetLatencyStats();
+            std::cout << "Audio latency (play call to mix, " << latency.m_samples << " plays): p50 " << latency.m_p50_ms
+                      << " ms, p90 " << latency.m_p90_ms << " ms, p99 " << latency.m_p99_ms << " ms, max " << latency.m_max_ms
+                      << " ms, + ~" << latency.m_buffer_ms << " ms device buffer" << std::endl;
+            const auto& events = sfxEvents.GetStats();
+            std::cout << "Sound effect events: " << events.requested << " requested, " << events.triggered
+                      << " triggered, " << events.deferred << " deferred by rate limits" << std::endl;
+        }
+#endif
+        return true;
+    }
+
+    // ============================================================================
+    // GAMEPLAY RENDERING
+    // ============================================================================
+    // Draws the world as it stands without moving it, so the simulator can render
+    // the same frame the game would at any tick.
+    void drawBackground() {
+        // Draw background decals
+        SetDecalMode(olc::DecalMode::ADDITIVE);
+        DrawDecal({ 0.0f, -bgOffset }, dec(SpriteId::BACKGROUND));
+        DrawDecal({ 0.0f, -bgOffset + spr(SpriteId::BACKGROUND)->height }, dec(SpriteId::BACKGROUND));
+
+        // CRITICAL FIX: Reset the Decal Mode for all other entities (Player, Bullets, Enemies)
+        // This ensures they are drawn correctly, typically with transparency/ALPHA blending.
+        SetDecalMode(olc::DecalMode::NORMAL);
+    }
+
+    // Entities (with screen shake), then the HUD on top
+    void drawGameplay() {
+        // Get screen shake offset
+        olc::vf2d shakeOff = getShakeOffset();
+
+        // 4. DRAW ENTITIES (Middle layers) - with screen shake applied
+        FrameProfiler::Scope drawing(profiler, FramePhase::DRAW_ENTITIES);
+        AllocTracker::Scope drawTag("draw entities");
+        for (auto& a : asteroids) a.Draw(this);
+        for (auto& e : enemies) e.Draw(this);
+        if (boss.alive && currentLevel == 3) boss.Draw(this);
+        for (auto& eb : enemyBullets) eb.Draw(this);
+        for (auto& b : bullets) b.Draw(this);
+        
+        // Draw power-ups
+        for (auto& p : powerups) p.Draw(this);
+        
+        // Draw player with shield effect if active
+        player.Draw(this);
+        if (hasShield()) {
+            // Draw shield bubble around player
+            DrawCircle(player.pos + shakeOff, int(player.r + 8), olc::BLUE);
+            DrawCircle(player.pos + shakeOff, int(player.r + 10), olc::CYAN);
+        }
+
+        for (auto& exp : explosions) {
+            // Ensure additive blending for glowing explosions
+            SetDecalMode(olc::DecalMode::ADDITIVE);
+
+            olc::vf2d size = { exp.decal->sprite->width * exp.scale, exp.decal->sprite->height * exp.scale };
+
+            // Draw decal centered on the entity's position + shake
+            DrawDecal(
+                exp.pos - size / 2.0f + shakeOff,
+                exp.decal,
+                { exp.scale, exp.scale }
+            );
+        }
+
+        // 5. DRAW HUD (Top layer)
+        drawing.Switch(FramePhase::DRAW_HUD);
+        AllocTracker::Scope hudTag("hud");
+
+        // Solid black background for main HUD (left side)
+        FillRect(0, 0, 220, 140, olc::Pixel(0, 0, 0, 240));
+        DrawRect(0, 0, 220, 140, olc::WHITE); // Border
+
+        std::string lvlText;
+        if (currentLevel == 1)
+            lvlText = "LEVEL 1: ASTEROID BELT";
+        else if (currentLevel == 2)
+            lvlText = "LEVEL 2: FRONTIER ZONE";
+        else if (currentLevel == 3)
+            lvlText = "LEVEL 3: ORBITAL SIEGE";
+
+        // Draw Level Text
+        DrawString(8, 8, lvlText, olc::WHITE, 1.5f);
+        DrawLine(8, 25, 212, 25, olc::Pixel(100, 100, 100));
+
+        // Draw Stats
+        DrawString(8, 32, "Score: " + std::to_string(score), olc::YELLOW, 1.5f);
+        DrawString(8, 50, "Lives: " + std::to_string(player.lives), olc::GREEN, 1.5f);
+        DrawString(8, 68, "Hits: " + std::to_string(hits), olc::RED, 1.5f);
+
+        // Active Power-ups indicator
+        int powerY = 86;
+        if (hasDoubleShot()) {
+            DrawString(8, powerY, "2X " + std::to_string(int(doubleShotTimer)) + "s", olc::YELLOW, 1);
+            powerY += 12;
+        }
+        if (hasSpeedBoost()) {
+            DrawString(8, powerY, "SPD " + std::to_string(int(speedBoostTimer)) + "s", olc::CYAN, 1);
+            powerY += 12;
+        }
+        if (hasShield()) {
+            DrawString(8, powerY, "SH " + std::to_string(int(shieldTimer)) + "s", olc::BLUE, 1);
+            powerY += 12;
+        }
+        
+        // Difficulty indicator (right side of HUD)
+        DrawString(130, 32, getDifficultyName(), 
+            (difficulty == Difficulty::EASY) ? olc::GREEN : 
+            (difficulty == Difficulty::NORMAL) ? olc::YELLOW : olc::RED, 1);
+
+        // Objective display
+        if (currentLevel == 1) {
+            int timeLeft = int(std::max(0.0f, GameConfig::LEVEL1_DURATION - levelTime));
+            DrawString(8, 120, "TIME: " + std::to_string(timeLeft) + "s", olc::CYAN, 1.5f);
+        }
+        else if (currentLevel == 2) {
+            DrawString(8, 120, "KILLS: " + std::to_string(enemiesKilled) + "/" + std::to_string(GameConfig::LEVEL2_KILL_TARGET), olc::CYAN, 1.5f);
+        }
+        else if (currentLevel == 3) {
+            // --- Right HUD Panel (Boss HP) ---
+            int barW = 200;
+            int barH = 15; // Slightly thinner bar
+            int barX = ScreenWidth() - barW - 15; // Move closer to right edge
+            int barY = 25; // Move higher up
+
+            float hpRatio = boss.alive ? float(boss.hp) / float(boss.maxHp) : 0.0f;
+            int hpW = int(barW * hpRatio);
+
+            // Background box for boss HP area (Condensed to height 60)
+            FillRect(barX - 10, barY - 25, barW + 20, 60, olc::Pixel(0, 0, 0, 240));
+            DrawRect(barX - 10, barY - 25, barW + 20, 60, olc::WHITE);
+
+            // Label above bar
+            // Adjusted Y-coordinate (-15) to sit closer to the bar
+            DrawString(barX + 65, barY - 15, "BOSS HP", olc::WHITE, 1.0f); // Reduced text scale for max compactness
+
+            // HP bar outline
+            DrawRect(barX - 2, barY - 2, barW + 4, barH + 4, olc::WHITE);
+            // Background
+            FillRect(barX, barY, barW, barH, olc::VERY_DARK_RED);
+            // Current HP
+            if (hpW > 0) {
+                olc::Pixel hpColor = hpRatio > 0.5f ? olc::GREEN : (hpRatio > 0.25f ? olc::YELLOW : olc::RED);
+                FillRect(barX, barY, hpW, barH, hpColor);
+            }
+
+            // HP text below bar
+            // Adjusted Y-coordinate (+18) to sit closer to the bar
+            std::string hpText = std::to_string(boss.hp) + " / " + std::to_string(boss.maxHp);
+            DrawString(barX + 55, barY + 18, hpText, olc::WHITE, 1.5f);
+        }
+    }
+
     bool OnUserUpdate(float dt) override
     {
+        // Gameplay frames, once the level has settled, are held to the allocation budget
+        allocations.SetSteadyState(state == GameState::PLAYING && levelTime > GameConfig::ALLOC_WARMUP_SECONDS);
         Clear(olc::BLACK);
 
         switch (state)
@@ -1298,10 +1988,10 @@ public:
             }
 
             if (GetKey(olc::Key::ENTER).bPressed || GetKey(olc::Key::SPACE).bPressed) {
+                beginRun();
                 state = GameState::STORY;
                 storyIndex = 0;
                 resetStorySlideState();  // Reset timers ONCE on enter
-                storyMusicPlaying = false;  // Allow music to start
                 playSound(sndMenuSelect, 1.0f);
             }
             if (GetKey(olc::Key::Q).bPressed) {
@@ -1313,13 +2003,11 @@ public:
         case GameState::STORY:
         {
             // Start music on first frame (if not already playing)
-            if (!storyMusicPlaying) {
-                startStoryMusic(StoryMood::NEUTRAL);
-            }
+            music.Play(storyTrack(StoryMood::NEUTRAL));
 
-            if (storyIndex < storyDecals.size()) {
+            if (storyIndex < storySlides.size()) {
                 bool skipOrAdvance = renderStorySlide(
-                    storyDecals[storyIndex], 
+                    storySlides[storyIndex]->decal.get(), 
                     storyText[storyIndex], 
                     StoryMood::NEUTRAL, 
                     dt
@@ -1328,7 +2016,7 @@ public:
                 if (skipOrAdvance) {
                     // Check if ESC skip (skip entire story)
                     if (storySkipTimer >= 1.5f) {
-                        stopStoryMusic();
+                        music.Stop();
                         startLevel(1);
                         introTimer = 0.0f;
                         state = GameState::LEVEL_INTRO;
@@ -1337,8 +2025,8 @@ public:
                         storyIndex++;
                         resetStorySlideState();
                         playSound(sndMenuSelect, 1.0f);
-                        if (storyIndex >= storyDecals.size()) {
-                            stopStoryMusic();
+                        if (storyIndex >= storySlides.size()) {
+                            music.Stop();
                                 startLevel(1);
                             introTimer = 0.0f;
                             state = GameState::LEVEL_INTRO;
@@ -1352,13 +2040,11 @@ public:
         case GameState::STORY_LEVEL2:
         {
             // Start music if not already playing
-            if (!storyMusicPlaying) {
-                startStoryMusic(StoryMood::NEUTRAL);
-            }
+            music.Play(storyTrack(StoryMood::NEUTRAL));
 
-            if (storyL2Index < storyL2Decals.size()) {
+            if (storyL2Index < storyL2Slides.size()) {
                 bool skipOrAdvance = renderStorySlide(
-                    storyL2Decals[storyL2Index], 
+                    storyL2Slides[storyL2Index]->decal.get(), 
                     storyL2Text[storyL2Index], 
                     StoryMood::NEUTRAL, 
                     dt
@@ -1366,7 +2052,7 @@ public:
 
                 if (skipOrAdvance) {
                     if (storySkipTimer >= 1.5f) {
-                        stopStoryMusic();
+                        music.Stop();
                         startLevel(2);
                         introTimer = 0.0f;
                         state = GameState::LEVEL_INTRO;
@@ -1374,8 +2060,8 @@ public:
                         storyL2Index++;
                         resetStorySlideState();
                         playSound(sndMenuSelect, 1.0f);
-                        if (storyL2Index >= storyL2Decals.size()) {
-                            stopStoryMusic();
+                        if (storyL2Index >= storyL2Slides.size()) {
+                            music.Stop();
                                 startLevel(2);
                             introTimer = 0.0f;
                             state = GameState::LEVEL_INTRO;
@@ -1389,13 +2075,11 @@ public:
         case GameState::STORY_LEVEL3:
         {
             // Start music if not already playing
-            if (!storyMusicPlaying) {
-                startStoryMusic(StoryMood::NEUTRAL);
-            }
+            music.Play(storyTrack(StoryMood::NEUTRAL));
 
-            if (storyL3Index < storyL3Decals.size()) {
+            if (storyL3Index < storyL3Slides.size()) {
                 bool skipOrAdvance = renderStorySlide(
-                    storyL3Decals[storyL3Index], 
+                    storyL3Slides[storyL3Index]->decal.get(), 
                     storyL3Text[storyL3Index], 
                     StoryMood::NEUTRAL, 
                     dt
@@ -1403,7 +2087,7 @@ public:
 
                 if (skipOrAdvance) {
                     if (storySkipTimer >= 1.5f) {
-                        stopStoryMusic();
+                        music.Stop();
                         startLevel(3);
                         introTimer = 0.0f;
                         state = GameState::LEVEL_INTRO;
@@ -1411,8 +2095,8 @@ public:
                         storyL3Index++;
                         resetStorySlideState();
                         playSound(sndMenuSelect, 1.0f);
-                        if (storyL3Index >= storyL3Decals.size()) {
-                            stopStoryMusic();
+                        if (storyL3Index >= storyL3Slides.size()) {
+                            music.Stop();
                                 startLevel(3);
                             introTimer = 0.0f;
                             state = GameState::LEVEL_INTRO;
@@ -1426,13 +2110,11 @@ public:
         case GameState::STORY_GAMEOVER:
         {
             // Start music if not already playing
-            if (!storyMusicPlaying) {
-                startStoryMusic(StoryMood::SAD);
-            }
+            music.Play(storyTrack(StoryMood::SAD));
 
-            if (storyGOIndex < storyGODecals.size()) {
+            if (storyGOIndex < storyGOSlides.size()) {
                 bool skipOrAdvance = renderStorySlide(
-                    storyGODecals[storyGOIndex], 
+                    storyGOSlides[storyGOIndex]->decal.get(), 
                     storyGOText[storyGOIndex], 
                     StoryMood::SAD, 
                     dt
@@ -1440,14 +2122,14 @@ public:
 
                 if (skipOrAdvance) {
                     if (storySkipTimer >= 1.5f) {
-                        stopStoryMusic();
+                        music.Stop();
                         state = GameState::GAME_OVER;
                     } else {
                         storyGOIndex++;
                         resetStorySlideState();
                         playSound(sndMenuSelect, 1.0f);
-                        if (storyGOIndex >= storyGODecals.size()) {
-                            stopStoryMusic();
+                        if (storyGOIndex >= storyGOSlides.size()) {
+                            music.Stop();
                                 state = GameState::GAME_OVER;
                         }
                     }
@@ -1459,13 +2141,11 @@ public:
         case GameState::STORY_VICTORY:
         {
             // Start music if not already playing
-            if (!storyMusicPlaying) {
-                startStoryMusic(StoryMood::TRIUMPHANT);
-            }
+            music.Play(storyTrack(StoryMood::TRIUMPHANT));
 
-            if (storyVictoryIndex < storyVictoryDecals.size()) {
+            if (storyVictoryIndex < storyVictorySlides.size()) {
                 bool skipOrAdvance = renderStorySlide(
-                    storyVictoryDecals[storyVictoryIndex], 
+                    storyVictorySlides[storyVictoryIndex]->decal.get(), 
                     storyVictoryText[storyVictoryIndex], 
                     StoryMood::TRIUMPHANT, 
                     dt
@@ -1473,14 +2153,14 @@ public:
 
                 if (skipOrAdvance) {
                     if (storySkipTimer >= 1.5f) {
-                        stopStoryMusic();
+                        music.Stop();
                         state = GameState::GAME_OVER;
                     } else {
                         storyVictoryIndex++;
                         resetStorySlideState();
                         playSound(sndMenuSelect, 1.0f);
-                        if (storyVictoryIndex >= storyVictoryDecals.size()) {
-                            stopStoryMusic();
+                        if (storyVictoryIndex >= storyVictorySlides.size()) {
+                            music.Stop();
                                 state = GameState::GAME_OVER;
                         }
                     }
@@ -1520,8 +2200,8 @@ public:
 
         case GameState::PLAYING:
         {
-            // Ensure no story music is playing during gameplay
-            forceStopAllStoryMusic();
+            // Ensure no story music is playing during gameplay (a no-op once it has faded out)
+            music.Stop();
             
             // Check for pause
             if (GetKey(olc::Key::ESCAPE).bPressed || GetKey(olc::Key::P).bPressed) {
@@ -1530,179 +2210,13 @@ public:
             }
 
             // 2. DRAW BACKGROUND (Lowest layer)
-            bgOffset += 40.0f * dt;
-            if (bgOffset >= sprBackground->height)
-                bgOffset -= sprBackground->height;
-
-            // Draw background decals
-            SetDecalMode(olc::DecalMode::ADDITIVE);
-            DrawDecal({ 0.0f, -bgOffset }, decBackground);
-            DrawDecal({ 0.0f, -bgOffset + sprBackground->height }, decBackground);
+            drawBackground();
 
-            // CRITICAL FIX: Reset the Decal Mode for all other entities (Player, Bullets, Enemies)
-            // This ensures they are drawn correctly, typically with transparency/ALPHA blending.
-            SetDecalMode(olc::DecalMode::NORMAL);
-
-            // 3. RUN GAME LOGIC/UPDATE/COLLISIONS
-            updateCurrentLevel(dt);
-
-            // Get screen shake offset
-            olc::vf2d shakeOff = getShakeOffset();
-
-            // 4. DRAW ENTITIES (Middle layers) - with screen shake applied
-            for (auto& a : asteroids) a.Draw(this);
-            for (auto& e : enemies) e.Draw(this);
-            if (boss.alive && currentLevel == 3) boss.Draw(this);
-            for (auto& eb : enemyBullets) eb.Draw(this);
-            for (auto& b : bullets) b.Draw(this);
-            
-            // Draw power-ups
-            for (auto& p : powerups) p.Draw(this);
-            
-            // Draw player with shield effect if active
-            player.Draw(this);
-            if (hasShield()) {
-                // Draw shield bubble around player
-                DrawCircle(player.pos + shakeOff, int(player.r + 8), olc::BLUE);
-                DrawCircle(player.pos + shakeOff, int(player.r + 10), olc::CYAN);
-            }
-
-            for (auto& exp : explosions) {
-                // Ensure additive blending for glowing explosions
-                SetDecalMode(olc::DecalMode::ADDITIVE);
-
-                olc::vf2d size = { exp.decal->sprite->width * exp.scale, exp.decal->sprite->height * exp.scale };
-
-                // Draw decal centered on the entity's position + shake
-                DrawDecal(
-                    exp.pos - size / 2.0f + shakeOff,
-                    exp.decal,
-                    { exp.scale, exp.scale }
-                );
-            }
-
-            // 5. DRAW HUD (Top layer)
-
-            // Solid black background for main HUD (left side)
-            FillRect(0, 0, 220, 140, olc::Pixel(0, 0, 0, 240));
-            DrawRect(0, 0, 220, 140, olc::WHITE); // Border
-
-            std::string lvlText;
-            if (currentLevel == 1)
-                lvlText = "LEVEL 1: ASTEROID BELT";
-            else if (currentLevel == 2)
-                lvlText = "LEVEL 2: FRONTIER ZONE";
-            else if (currentLevel == 3)
-                lvlText = "LEVEL 3: ORBITAL SIEGE";
-
-            // Draw Level Text
-            DrawString(8, 8, lvlText, olc::WHITE, 1.5f);
-            DrawLine(8, 25, 212, 25, olc::Pixel(100, 100, 100));
-
-            // Draw Stats
-            DrawString(8, 32, "Score: " + std::to_string(score), olc::YELLOW, 1.5f);
-            DrawString(8, 50, "Lives: " + std::to_string(player.lives), olc::GREEN, 1.5f);
-            DrawString(8, 68, "Hits: " + std::to_string(hits), olc::RED, 1.5f);
-
-            // Active Power-ups indicator
-            int powerY = 86;
-            if (hasDoubleShot()) {
-                DrawString(8, powerY, "2X " + std::to_string(int(doubleShotTimer)) + "s", olc::YELLOW, 1);
-                powerY += 12;
-            }
-            if (hasSpeedBoost()) {
-                DrawString(8, powerY, "SPD " + std::to_string(int(speedBoostTimer)) + "s", olc::CYAN, 1);
-                powerY += 12;
-            }
-            if (hasShield()) {
-                DrawString(8, powerY, "SH " + std::to_string(int(shieldTimer)) + "s", olc::BLUE, 1);
-                powerY += 12;
-            }
-            
-            // Difficulty indicator (right side of HUD)
-            DrawString(130, 32, getDifficultyName(), 
-                (difficulty == Difficulty::EASY) ? olc::GREEN : 
-                (difficulty == Difficulty::NORMAL) ? olc::YELLOW : olc::RED, 1);
-
-            // Objective display
-            if (currentLevel == 1) {
-                int timeLeft = int(std::max(0.0f, GameConfig::LEVEL1_DURATION - levelTime));
-                DrawString(8, 120, "TIME: " + std::to_string(timeLeft) + "s", olc::CYAN, 1.5f);
-            }
-            else if (currentLevel == 2) {
-                DrawString(8, 120, "KILLS: " + std::to_string(enemiesKilled) + "/" + std::to_string(GameConfig::LEVEL2_KILL_TARGET), olc::CYAN, 1.5f);
-            }
-            else if (currentLevel == 3) {
-                // --- Right HUD Panel (Boss HP) ---
-                int barW = 200;
-                int barH = 15; // Slightly thinner bar
-                int barX = ScreenWidth() - barW - 15; // Move closer to right edge
-                int barY = 25; // Move higher up
-
-                float hpRatio = boss.alive ? float(boss.hp) / float(boss.maxHp) : 0.0f;
-                int hpW = int(barW * hpRatio);
-
-                // Background box for boss HP area (Condensed to height 60)
-                FillRect(barX - 10, barY - 25, barW + 20, 60, olc::Pixel(0, 0, 0, 240));
-                DrawRect(barX - 10, barY - 25, barW + 20, 60, olc::WHITE);
-
-                // Label above bar
-                // Adjusted Y-coordinate (-15) to sit closer to the bar
-                DrawString(barX + 65, barY - 15, "BOSS HP", olc::WHITE, 1.0f); // Reduced text scale for max compactness
-
-                // HP bar outline
-                DrawRect(barX - 2, barY - 2, barW + 4, barH + 4, olc::WHITE);
-                // Background
-                FillRect(barX, barY, barW, barH, olc::VERY_DARK_RED);
-                // Current HP
-                if (hpW > 0) {
-                    olc::Pixel hpColor = hpRatio > 0.5f ? olc::GREEN : (hpRatio > 0.25f ? olc::YELLOW : olc::RED);
-                    FillRect(barX, barY, hpW, barH, hpColor);
-                }
-
-                // HP text below bar
-                // Adjusted Y-coordinate (+18) to sit closer to the bar
-                std::string hpText = std::to_string(boss.hp) + " / " + std::to_string(boss.maxHp);
-                DrawString(barX + 55, barY + 18, hpText, olc::WHITE, 1.5f);
-            }
-
-
-            // 6. LEVEL COMPLETE CHECK
-            if (player.lives > 0) {
-                if (currentLevel == 1) {
-                    if (levelTime >= GameConfig::LEVEL1_DURATION) {
-                        playSound(sndLevelComplete, 1.0f);
-                        // Go to Level 2 Story instead of directly to Level 2
-                        state = GameState::STORY_LEVEL2;
-                        storyL2Index = 0;
-                        resetStorySlideState();
-                        storyMusicPlaying = false;
-                    }
-                }
-                else if (currentLevel == 2) {
-                    if (enemiesKilled >= GameConfig::LEVEL2_KILL_TARGET) {
-                        playSound(sndLevelComplete, 1.0f);
-                        // Go to Level 3 Story instead of direct Level 3
-                        state = GameState::STORY_LEVEL3;
-                        storyL3Index = 0;
-                        resetStorySlideState();
-                        storyMusicPlaying = false;
-                    }
-                }
-                else if (currentLevel == 3) {
-                    if (!boss.alive) {
-                        playSound(sndLevelComplete, 1.0f);  // Victory!
-                        // Go to Victory Story instead of directly to Game Over
-                        state = GameState::STORY_VICTORY;
-                        storyVictoryIndex = 0;
-                        resetStorySlideState();
-                        storyMusicPlaying = false;
-                        wins = true;
-                        saveHighScore();
-                    }
-                }
-            }
+            // 3. RUN GAME LOGIC/UPDATE/COLLISIONS (and the level complete check)
+            stepGameplay(dt);
 
+            // 4. DRAW ENTITIES AND HUD
+            drawGameplay();
             break;
         }
 
@@ -1727,6 +2241,7 @@ public:
             }
             if (GetKey(olc::Key::Q).bPressed) {
                 saveHighScore();
+                finishRun();
                 state = GameState::MENU;
             }
             break;
@@ -1768,21 +2283,607 @@ public:
             
             DrawString(x5, ScreenHeight() / 2 + 75, line5, olc::CYAN, 1);
 
+            bool canRetryBoss = !wins && currentLevel == 3 && !bossCheckpoint.empty();
+            if (canRetryBoss) {
+                DrawString(ScreenWidth() / 2 - 88, ScreenHeight() / 2 + 90, "Press R to Retry the Boss", olc::GREY, 1);
+            }
+
             if (GetKey(olc::Key::ENTER).bPressed) {
                 state = GameState::MENU;
             }
+            else if (canRetryBoss && GetKey(olc::Key::R).bPressed && restoreSnapshot(bossCheckpoint)) {
+                introTimer = 0.0f;
+                state = GameState::LEVEL_INTRO;
+            }
             break;
         }
         }
 
+        // Every effect requested this frame goes out as one merged trigger per sound
+        submitSounds(dt);
+        music.Update(dt);
         return true;
     }
 };
 
+#ifdef STARFALL_SIM
+// ============================================================================
+// HEADLESS SIMULATION
+// ============================================================================
+// Built by Operation_Starfall_Sim.vcxproj with OLC_PGE_HEADLESS, so it needs
+// no display, GPU or sound card. Loads the game as usual, then runs
+// updateCurrentLevel at a fixed dt as fast as it will go, steered by a bot
+// or a script, and reports throughput, entity counts and the score. Each
+// tick's audio is mixed offline after it; STARFALL_AUDIO_WAV=<file> keeps it.
+//
+//   Operation_Starfall_Sim [ticks] [--dt seconds] [--seed n] [--level 1-3]
+//                          [--difficulty easy|normal|hard] [--script file]
+//                          [--record file] [--replay file]
+//                          [--frames t1,t2,...] [--golden dir] [--update-golden]
+//                          [--tolerance n]
+//
+// A script is lines of "<ticks> <dx> <dy>" (# starts a comment), held in
+// turn and repeated from the top when they run out.
+//
+// --record saves the run as a replay, --replay re-simulates one (from the
+// game's STARFALL_RECORD or an earlier --record) with its own seed, level,
+// difficulty and dt, then checks the end state and reports per-tick times.
+// Either stops at the end of the first game.
+//
+// --frames renders the listed ticks (0-based, after that tick's update)
+// through FrameCapture's CPU compositor and prints a hash of each. With
+// --golden they are compared to <dir>/tick_<n>.ppm: a pixel differs when a
+// channel is off by more than the tolerance, and a frame fails when more
+// than GOLDEN_MAX_DIFF_FRACTION of its pixels differ, leaving .actual.ppm and
+// .diff.ppm beside the golden. --update-golden writes the goldens instead.
+// Goldens belong to one scenario, so pair a directory with a fixed replay or
+// seed, level, difficulty and script. The checked-in set covers the boss
+// fight, shaking and still, and the Sim project checks it after every build:
+//
+//   Operation_Starfall_Sim 1200 --seed 5 --level 3 --frames 120,600,1100 --golden goldens/boss_seed5
+//
+// Re-record it with --update-golden when a change to the visuals is meant.
+struct SimOptions {
+    long long ticks = 36000;            // 10 minutes at 60 Hz
+    float dt = 1.0f / 60.0f;
+    unsigned seed = 1;
+    int level = 1;
+    Difficulty difficulty = Difficulty::NORMAL;
+    std::string script;
+    std::string record;
+    std::string replay;
+    std::vector<long long> frames;      // Sorted
+    std::string golden;
+    bool updateGolden = false;
+    int tolerance = GameConfig::GOLDEN_CHANNEL_TOLERANCE;
+};
+
+// Holds every gameplay tick past a level's warm-up to the allocation budget, and
+// says which tags the steady-state allocations came from
+class AllocationWatch {
+public:
+    // Around each tick; ticks still in the level's warm-up are ignored
+    void Begin(float levelTime) {
+        measuring = AllocTracker::COMPILED_IN && levelTime > GameConfig::ALLOC_WARMUP_SECONDS;
+        if (!measuring) return;
+        tickStart = AllocTracker::GetThreadCounts();
+        tagCount = AllocTracker::GetTags(tagsAtStart);
+    }
+
+    void End() {
+        if (!measuring) return;
+        AllocTracker::Counts tick = AllocTracker::GetThreadCounts() - tickStart;
+        ticks++;
+        total.allocations += tick.allocations;
+        total.bytes += tick.bytes;
+        peak = std::max(peak, tick.allocations);
+        if (tick.allocations > GameConfig::ALLOC_BUDGET_PER_TICK) overBudget++;
+
+        std::array<AllocTracker::TagCounts, AllocTracker::MAX_TAGS> tags;
+        size_t count = AllocTracker::GetTags(tags);
+        for (size_t i = 0; i < count; i++) {
+            tagTotals[i].tag = tags[i].tag;
+            tagTotals[i].counts.allocations += tags[i].counts.allocations - (i < tagCount ? tagsAtStart[i].counts.allocations : 0);
+        }
+        tagTotalCount = count;
+    }
+
+    // False if any tick went over budget
+    bool Report() const {
+        if (!AllocTracker::COMPILED_IN) {
+            std::cout << "  Allocations: not tracked, build with STARFALL_ALLOC_TRACKING" << std::endl;
+            return true;
+        }
+        if (ticks == 0) return true;
+
+        std::cout << std::setprecision(2) << "  Allocations: " << total.allocations << " in " << ticks << " steady ticks ("
+                  << double(total.allocations) / ticks << " per tick, peak " << peak << ", " << total.bytes / 1024
+                  << " KB), budget " << GameConfig::ALLOC_BUDGET_PER_TICK << std::setprecision(1) << std::endl;
+        for (size_t i = 0; i < tagTotalCount; i++) {
+            if (tagTotals[i].counts.allocations > 0) {
+                std::cout << "    - " << tagTotals[i].tag << ": " << tagTotals[i].counts.allocations << std::endl;
+            }
+        }
+
+        if (overBudget > 0) {
+            std::cerr << "ERROR: " << overBudget << " of " << ticks << " steady gameplay ticks went over the allocation budget" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+private:
+    bool measuring = false;
+    AllocTracker::Counts tickStart;
+    std::array<AllocTracker::TagCounts, AllocTracker::MAX_TAGS> tagsAtStart{};
+    size_t tagCount = 0;
+
+    uint64_t ticks = 0;
+    uint64_t peak = 0;
+    uint64_t overBudget = 0;
+    AllocTracker::Counts total;
+    std::array<AllocTracker::TagCounts, AllocTracker::MAX_TAGS> tagTotals{};
+    size_t tagTotalCount = 0;
+};
+
+class SimulationRunner : public SpaceShooter
+{
+public:
+    explicit SimulationRunner(const SimOptions& options) : options(options) {
+        saveHighScores = false;
+        player.inputOverride = &input;
+        profiler.SetEnabled(false);
+        allocations.SetEnabled(false);
+    }
+
+    bool OnUserUpdate(float) override {
+        if (!loadScript() || !loadReplay()) {
+            failed = true;
+            return false;
+        }
+        run();
+        return false;
+    }
+
+    bool failed = false;
+
+private:
+    struct ScriptStep {
+        long long ticks = 0;
+        olc::vf2d dir;
+    };
+
+    SimOptions options;
+    olc::vf2d input;
+    std::vector<ScriptStep> script;
+    olc::Sprite frame;
+    int framesChecked = 0;
+    int framesFailed = 0;
+    double audioFrameCarry = 0.0;   // Fraction of a sample frame a tick's audio left over
+    std::vector<float> audioMix;    // One tick's mix, sized before the first tick
+    uint64_t audioHash = Replay::Hash(nullptr, 0);  // Every sample mixed so far
+    uint64_t audioRenders = 0;      // With STARFALL_ALLOC_TRACKING: Render calls, and those that allocated
+    uint64_t audioRendersAllocating = 0;
+    uint64_t audioRenderAllocations = 0;
+
+    bool loadScript() {
+        if (options.script.empty()) return true;
+
+        std::ifstream file(options.script);
+        if (!file.is_open()) {
+            std::cerr << "ERROR: Could not open sim script: " << options.script << std::endl;
+            return false;
+        }
+
+        std::string line;
+        while (std::getline(file, line)) {
+            line = line.substr(0, line.find('#'));
+            std::istringstream fields(line);
+            ScriptStep step;
+            if (fields >> step.ticks >> step.dir.x >> step.dir.y && step.ticks > 0) script.push_back(step);
+        }
+        if (script.empty()) {
+            std::cerr << "ERROR: Sim script has no steps: " << options.script << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool loadReplay() {
+        if (options.replay.empty()) return true;
+        if (!replay.Load(options.replay)) return false;
+
+        const Replay::Header& header = replay.GetHeader();
+        options.ticks = (long long)replay.GetTickCount();
+        options.dt = header.dt;
+        options.seed = header.seed;
+        options.level = std::clamp(int(header.level), 1, 3);
+        options.difficulty = static_cast<Difficulty>(header.difficulty);
+        return true;
+    }
+
+    olc::vf2d scriptInput(long long tick) const {
+        long long length = 0;
+        for (const auto& step : script) length += step.ticks;
+
+        tick %= length;
+        for (const auto& step : script) {
+            if (tick < step.ticks) return step.dir;
+            tick -= step.ticks;
+        }
+        return {};
+    }
+
+    // Sidesteps the closest thing about to hit the ship, otherwise lines up under the nearest target
+    olc::vf2d botInput() const {
+        olc::vf2d dir = { 0.0f, 0.0f };
+        const float lookAhead = 160.0f;
+
+        float closestThreat = lookAhead;
+        bool threatened = false;
+        auto considerThreat = [&](const olc::vf2d& pos, float r) {
+            float above = player.pos.y - pos.y;
+            if (above < -r || above > closestThreat) return;
+            if (std::fabs(pos.x - player.pos.x) > player.r + r + 16.0f) return;
+            closestThreat = above;
+            threatened = true;
+            dir.x = (pos.x > player.pos.x) ? -1.0f : 1.0f;
+        };
+        for (const auto& a : asteroids) if (a.alive) considerThreat(a.pos, a.r);
+        for (const auto& e : enemies) if (e.alive) considerThreat(e.pos, e.r);
+        for (const auto& eb : enemyBullets) if (eb.alive) considerThreat(eb.pos, eb.r);
+
+        // Stuck against a wall, dodge the other way
+        if (threatened) {
+            if (player.pos.x <= player.r + 1.0f) dir.x = 1.0f;
+            if (player.pos.x >= ScreenWidth() - player.r - 1.0f) dir.x = -1.0f;
+            return dir;
+        }
+
+        float targetX = ScreenWidth() / 2.0f;
+        float closest = 1e9f;
+        auto considerTarget = [&](const olc::vf2d& pos) {
+            float d = std::fabs(pos.x - player.pos.x);
+            if (pos.y < player.pos.y && d < closest) {
+                closest = d;
+                targetX = pos.x;
+            }
+        };
+        for (const auto& a : asteroids) if (a.alive) considerTarget(a.pos);
+        for (const auto& e : enemies) if (e.alive) considerTarget(e.pos);
+        if (boss.alive && currentLevel == 3) considerTarget(boss.pos);
+
+        if (std::fabs(targetX - player.pos.x) > 4.0f) dir.x = (targetX > player.pos.x) ? 1.0f : -1.0f;
+        if (player.pos.y < ScreenHeight() - 80.0f) dir.y = 1.0f;
+        return dir;
+    }
+
+    void run() {
+        const bool replaying = !options.replay.empty();
+        const bool recording = !options.record.empty() && !replaying;
+
+        seedRandom(options.seed);
+        difficulty = options.difficulty;
+        ResetGame();
+        if (options.level > 1) startLevel(options.level);
+        state = GameState::PLAYING;
+
+        // A tick mixes at most one frame more than dt covers, carried over from earlier ticks
+        if (audioLoaded) {
+            size_t tickFrames = size_t(std::ceil(double(options.dt) * audio.GetDeviceSettings().m_sample_rate)) + 1;
+            audioMix.assign(tickFrames * 2, 0.0f);
+        }
+
+        if (recording) {
+            Replay::Header header;
+            header.seed = options.seed;
+            header.difficulty = uint8_t(options.difficulty);
+            header.level = uint8_t(options.level);
+            header.dt = options.dt;
+            replay.Begin(header);
+        }
+
+        size_t peakAsteroids = 0, peakEnemies = 0, peakBullets = 0, peakEnemyBullets = 0, peakPowerUps = 0, peakExplosions = 0;
+        int games = 1, won = 0, bestScore = 0;
+        long long ticksRun = options.ticks;
+        std::vector<float> tickMicros;
+        if (replaying) tickMicros.reserve(size_t(options.ticks));
+        AllocationWatch allocWatch;
+
+        auto start = StartupProfiler::Clock::now();
+        for (long long tick = 0; tick < options.ticks; tick++) {
+            if (replaying) {
+                input = Replay::ToDirection(replay.Input(size_t(tick)));
+            }
+            else {
+                input = script.empty() ? botInput() : scriptInput(tick);
+                if (recording) {
+                    // A recorded run moves exactly as the bitmask it stores
+                    uint8_t mask = Replay::FromDirection(input);
+                    replay.Record(mask);
+                    input = Replay::ToDirection(mask);
+                }
+            }
+
+            auto tickStart = StartupProfiler::Clock::now();
+            allocWatch.Begin(levelTime);
+            updateCurrentLevel(options.dt);
+            checkLevelComplete();
+            if (replaying) tickMicros.push_back(float(StartupProfiler::MsSince(tickStart) * 1000.0));
+            submitSounds(options.dt);
+            allocWatch.End();
+            renderAudio(options.dt);
+
+            if (std::binary_search(options.frames.begin(), options.frames.end(), tick)) checkFrame(tick);
+
+            peakAsteroids = std::max(peakAsteroids, asteroids.size());
+            peakEnemies = std::max(peakEnemies, enemies.size());
+            peakBullets = std::max(peakBullets, bullets.size());
+            peakEnemyBullets = std::max(peakEnemyBullets, enemyBullets.size());
+            peakPowerUps = std::max(peakPowerUps, powerups.size());
+            peakExplosions = std::max(peakExplosions, explosions.size());
+
+            // Skip the story slides between levels; a finished game starts over
+            if (state == GameState::STORY_LEVEL2) startLevel(2);
+            else if (state == GameState::STORY_LEVEL3) startLevel(3);
+            else if (state == GameState::STORY_VICTORY || state == GameState::STORY_GAMEOVER) {
+                if (state == GameState::STORY_VICTORY) won++;
+                bestScore = std::max(bestScore, score);
+                if (replaying || recording) {
+                    ticksRun = tick + 1;
+                    break;
+                }
+                if (tick + 1 < options.ticks) {
+                    games++;
+                    ResetGame();
+                }
+            }
+            state = GameState::PLAYING;
+        }
+        double ms = StartupProfiler::MsSince(start);
+        bestScore = std::max(bestScore, score);
+
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "Simulation: " << ticksRun << " ticks at dt " << options.dt * 1000.0f << " ms, seed " << options.seed
+                  << (replaying ? ", replayed input" : script.empty() ? ", bot input" : ", scripted input") << std::endl;
+        std::cout << "  Wall time: " << ms << " ms, " << (ms > 0.0 ? ticksRun * 1000.0 / ms : 0.0) << " ticks/sec, "
+                  << (ms > 0.0 ? ticksRun * options.dt * 1000.0 / ms : 0.0) << "x real time" << std::endl;
+        std::cout << "  Entities now/peak: asteroids " << asteroids.size() << "/" << peakAsteroids
+                  << ", enemies " << enemies.size() << "/" << peakEnemies
+                  << ", bullets " << bullets.size() << "/" << peakBullets
+                  << ", enemy bullets " << enemyBullets.size() << "/" << peakEnemyBullets
+                  << ", power-ups " << powerups.size() << "/" << peakPowerUps
+                  << ", explosions " << explosions.size() << "/" << peakExplosions << std::endl;
+        std::cout << "  Games: " << games << " (" << won << " won), level " << currentLevel << ", lives " << player.lives
+                  << ", hits " << hits << std::endl;
+        std::cout << "  Final score: " << score << ", best " << bestScore << std::endl;
+        if (replaying) printTickTimes(tickMicros);
+        if (!options.frames.empty()) {
+            std::cout << "  Frames: " << framesChecked << " rendered";
+            if (!options.golden.empty() && !options.updateGolden) std::cout << ", " << framesFailed << " differ from golden";
+            std::cout << std::endl;
+        }
+        if (!allocWatch.Report()) failed = true;
+        if (!reportAudioAllocations()) failed = true;
+        checkSnapshotRoundTrip();
+        std::cout << std::defaultfloat;
+
+        if (recording) {
+            replay.GetHeader().stateHash = stateHash();
+            if (audioLoaded) replay.GetHeader().audioHash = audioHash;
+            if (replay.Save(options.record)) {
+                std::cout << "Replay saved: " << options.record << " (" << replay.GetTickCount() << " ticks)" << std::endl;
+            }
+        }
+        if (replaying) {
+            uint64_t expected = replay.GetHeader().stateHash;
+            if (ticksRun != options.ticks || (expected != 0 && expected != stateHash())) {
+                std::cerr << "ERROR: Replay desynced, the final state differs from the recording" << std::endl;
+                failed = true;
+            }
+            else if (audioLoaded && replay.GetHeader().audioHash != 0 && replay.GetHeader().audioHash != audioHash) {
+                std::cerr << "ERROR: Replay desynced, the mixed audio differs from the recording" << std::endl;
+                failed = true;
+            }
+            else {
+                std::cout << "Replay in sync" << std::endl;
+            }
+        }
+    }
+
+    // Mixes the audio one tick covers. Without a device the queue applies commands as
+    // they are made, so the mix is a function of the seed and input alone and is hashed
+    void renderAudio(float dt) {
+        if (!audioLoaded) return;
+        audioFrameCarry += double(dt) * audio.GetDeviceSettings().m_sample_rate;
+        ma_uint64 frames = ma_uint64(audioFrameCarry);
+        audioFrameCarry -= double(frames);
+
+        // The mix runs the same code as the device callback, so it must not allocate either
+        AllocTracker::Counts before = AllocTracker::GetThreadCounts();
+        audio.Render(frames, audioMix.data());
+        uint64_t allocated = (AllocTracker::GetThreadCounts() - before).allocations;
+        audioHash = Replay::Hash(audioMix.data(), size_t(frames) * 2 * sizeof(float), audioHash);
+        audioRenders++;
+        if (allocated > 0) {
+            audioRendersAllocating++;
+            audioRenderAllocations += allocated;
+        }
+    }
+
+    // False if any tick's mix allocated
+    bool reportAudioAllocations() const {
+        if (!AllocTracker::COMPILED_IN || audioRenders == 0) return true;
+
+        std::cout << "  Audio mix allocations: " << audioRenderAllocations << " in " << audioRenders << " renders" << std::endl;
+        if (audioRendersAllocating > 0) {
+            std::cerr << "ERROR: The audio mix allocated in " << audioRendersAllocating << " of " << audioRenders << " ticks" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Draws this tick as the game would, composites layer 0 on the CPU and checks
+    // it against its golden; the decals are dropped so they never reach the engine
+    void checkFrame(long long tick) {
+        Clear(olc::BLACK);
+        drawBackground();
+        drawGameplay();
+        FrameCapture::Composite(*this, frame);
+        GetLayers()[0].vecDecalInstance.clear();
+        framesChecked++;
+
+        uint64_t hash = Replay::Hash(frame.GetData(), frame.pColData.size() * sizeof(olc::Pixel));
+        std::cout << "  Frame " << tick << ": hash " << std::hex << std::setw(16) << std::setfill('0') << hash
+                  << std::dec << std::setfill(' ');
+        if (options.golden.empty()) {
+            std::cout << std::endl;
+            return;
+        }
+
+        const std::string base = options.golden + "/tick_" + std::to_string(tick);
+        if (options.updateGolden) {
+            if (FrameCapture::SavePPM(base + ".ppm", frame)) std::cout << ", golden written" << std::endl;
+            else failed = true;
+            return;
+        }
+
+        olc::Sprite expected;
+        if (!FrameCapture::LoadPPM(base + ".ppm", expected)) {
+            std::cout << std::endl;
+            std::cerr << "ERROR: No golden frame " << base << ".ppm, record it with --update-golden" << std::endl;
+            framesFailed++;
+            failed = true;
+            return;
+        }
+
+        olc::Sprite diffImage;
+        FrameCapture::Diff diff = FrameCapture::Compare(expected, frame, options.tolerance, &diffImage);
+        const int allowed = int(GameConfig::GOLDEN_MAX_DIFF_FRACTION * frame.pColData.size());
+        std::cout << ", " << diff.pixels << " pixels differ, max delta " << diff.maxDelta << std::endl;
+        if (!diff.sizeMismatch && diff.pixels <= allowed) return;
+
+        FrameCapture::SavePPM(base + ".actual.ppm", frame);
+        if (diff.sizeMismatch) {
+            std::cerr << "ERROR: Frame " << tick << " is " << frame.width << "x" << frame.height
+                      << ", its golden is " << expected.width << "x" << expected.height << std::endl;
+        }
+        else {
+            FrameCapture::SavePPM(base + ".diff.ppm", diffImage);
+            std::cerr << "ERROR: Frame " << tick << " differs from its golden in " << diff.pixels
+                      << " pixels (" << allowed << " allowed), see " << base << ".diff.ppm" << std::endl;
+        }
+        framesFailed++;
+        failed = true;
+    }
+
+    // Saves and restores the final world many times over, to time both and to check
+    // that the same state, and the same bytes, come back
+    void checkSnapshotRoundTrip() {
+        const int repeats = 1000;
+        const uint64_t hash = stateHash();
+
+        std::vector<uint8_t> snapshot;
+        auto saveStart = StartupProfiler::Clock::now();
+        for (int i = 0; i < repeats; i++) snapshot = saveSnapshot();
+        double saveMicros = StartupProfiler::MsSince(saveStart) * 1000.0 / repeats;
+
+        bool restored = true;
+        auto restoreStart = StartupProfiler::Clock::now();
+        for (int i = 0; i < repeats; i++) restored = restoreSnapshot(snapshot) && restored;
+        double restoreMicros = StartupProfiler::MsSince(restoreStart) * 1000.0 / repeats;
+
+        std::cout << std::setprecision(2) << "  Snapshot: " << snapshot.size() << " bytes"
+                  << (snapshot.size() > GameConfig::SNAPSHOT_BUDGET_BYTES ? " (over budget)" : "")
+                  << ", save " << saveMicros << " us, restore " << restoreMicros << " us" << std::setprecision(1) << std::endl;
+
+        if (!restored || stateHash() != hash || saveSnapshot() != snapshot) {
+            std::cerr << "ERROR: Snapshot round trip changed the world" << std::endl;
+            failed = true;
+        }
+    }
+
+    // Per-tick update cost over a replay, and where in it the slowest ticks were
+    void printTickTimes(const std::vector<float>& micros) const {
+        if (micros.empty()) return;
+
+        std::vector<float> sorted = micros;
+        std::sort(sorted.begin(), sorted.end());
+        auto percentile = [&](double p) { return sorted[std::min(sorted.size() - 1, size_t(p * sorted.size()))]; };
+        std::cout << "  Tick update: p50 " << percentile(0.50) << " us, p99 " << percentile(0.99)
+                  << " us, max " << sorted.back() << " us" << std::endl;
+
+        std::vector<size_t> slowest(micros.size());
+        for (size_t i = 0; i < slowest.size(); i++) slowest[i] = i;
+        size_t count = std::min<size_t>(5, slowest.size());
+        std::partial_sort(slowest.begin(), slowest.begin() + count, slowest.end(),
+            [&](size_t a, size_t b) { return micros[a] > micros[b]; });
+
+        std::cout << "  Slowest ticks:";
+        for (size_t i = 0; i < count; i++) {
+            std::cout << " #" << slowest[i] << " (" << slowest[i] * options.dt << " s) " << micros[slowest[i]] << " us"
+                      << (i + 1 < count ? "," : "");
+        }
+        std::cout << std::endl;
+    }
+};
+
+static bool parseSimOptions(int argc, char** argv, SimOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--dt" && hasValue) options.dt = float(std::atof(argv[++i]));
+        else if (arg == "--seed" && hasValue) options.seed = unsigned(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--level" && hasValue) options.level = std::clamp(std::atoi(argv[++i]), 1, 3);
+        else if (arg == "--script" && hasValue) options.script = argv[++i];
+        else if (arg == "--record" && hasValue) options.record = argv[++i];
+        else if (arg == "--replay" && hasValue) options.replay = argv[++i];
+        else if (arg == "--frames" && hasValue) {
+            std::istringstream list(argv[++i]);
+            std::string tick;
+            while (std::getline(list, tick, ',')) {
+                if (!tick.empty()) options.frames.push_back(std::atoll(tick.c_str()));
+            }
+            std::sort(options.frames.begin(), options.frames.end());
+        }
+        else if (arg == "--golden" && hasValue) options.golden = argv[++i];
+        else if (arg == "--update-golden") options.updateGolden = true;
+        else if (arg == "--tolerance" && hasValue) options.tolerance = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--difficulty" && hasValue) {
+            std::string d = argv[++i];
+            if (d == "easy") options.difficulty = Difficulty::EASY;
+            else if (d == "hard") options.difficulty = Difficulty::HARD;
+            else options.difficulty = Difficulty::NORMAL;
+        }
+        else if (!arg.empty() && std::isdigit(static_cast<unsigned char>(arg[0]))) options.ticks = std::atoll(arg.c_str());
+        else {
+            std::cerr << "Usage: " << argv[0] << " [ticks] [--dt seconds] [--seed n] [--level 1-3]"
+                      << " [--difficulty easy|normal|hard] [--script file] [--record file] [--replay file]"
+                      << " [--frames t1,t2,...] [--golden dir] [--update-golden] [--tolerance n]" << std::endl;
+            return false;
+        }
+    }
+    return options.dt > 0.0f;
+}
+
+int main(int argc, char** argv)
+{
+    SimOptions options;
+    if (!parseSimOptions(argc, argv, options))
+        return 2;
+
+    SimulationRunner sim(options);
+    if (sim.Construct(900, 600, 1, 1))
+        sim.Start();
+    return (sim.startupOverBudget || sim.failed) ? 1 : 0;
+}
+#else
 int main()
 {
     SpaceShooter game;
     if (game.Construct(900, 600, 1, 1))
         game.Start();
-    return 0;
-}
\ No newline at end of file
+    return game.startupOverBudget ? 1 : 0;
+}
+#endif
\ No newline at end of file
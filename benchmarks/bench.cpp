@@ -0,0 +1,135 @@
+#include "bench.h"
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace Bench {
+    namespace {
+        double runOnce(const Runner::Body& body, uint64_t iterations) {
+            auto start = Clock::now();
+            body(iterations);
+            return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        }
+
+        std::string jsonString(const std::string& s) {
+            std::string out = "\"";
+            for (char c : s) {
+                if (c == '"' || c == '\\') out += '\\';
+                out += c;
+            }
+            return out + "\"";
+        }
+
+        std::string compilerName() {
+#if defined(__clang__)
+            return "clang " __clang_version__;
+#elif defined(__GNUC__)
+            return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+            return "msvc " + std::to_string(_MSC_VER);
+#else
+            return "unknown";
+#endif
+        }
+    }
+
+    void Runner::Run(const std::string& name, const Body& body, double itemsPerOp) {
+        lastRan = options.filter.empty() || name.find(options.filter) != std::string::npos;
+        if (!lastRan) return;
+
+        // Warm caches and lazy allocations, then grow the batch until one sample is long enough to time
+        const double minSampleNs = options.minSampleMs * 1e6;
+        uint64_t iterations = 1;
+        double ns = runOnce(body, iterations);
+        while (ns < minSampleNs && iterations < (uint64_t(1) << 40)) {
+            iterations *= 2;
+            ns = runOnce(body, iterations);
+        }
+
+        std::vector<double> perOp;
+        for (int i = 0; i < std::max(1, options.samples); i++) {
+            perOp.push_back(runOnce(body, iterations) / double(iterations));
+        }
+        std::sort(perOp.begin(), perOp.end());
+
+        Result result;
+        result.name = name;
+        result.iterations = iterations;
+        result.samples = int(perOp.size());
+        result.nsPerOp = perOp[perOp.size() / 2];
+        result.minNs = perOp.front();
+        result.maxNs = perOp.back();
+        if (itemsPerOp > 0.0 && result.nsPerOp > 0.0) result.itemsPerSecond = itemsPerOp * 1e9 / result.nsPerOp;
+        results.push_back(result);
+
+        std::cout << std::left << std::setw(40) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << result.nsPerOp << " ns" << std::setw(14) << result.minNs << " min"
+                  << std::setw(14) << result.maxNs << " max";
+        if (result.itemsPerSecond > 0.0) {
+            std::cout << std::setprecision(2) << std::setw(12) << result.itemsPerSecond / 1e6 << " M items/s";
+        }
+        std::cout << std::defaultfloat << std::endl;
+    }
+
+    void Runner::Skip(const std::string& name, const std::string& reason) {
+        lastRan = false;
+        if (!options.filter.empty() && name.find(options.filter) == std::string::npos) return;
+        std::cout << std::left << std::setw(40) << name << std::right << " skipped: " << reason << std::endl;
+    }
+
+    void Runner::Counter(const std::string& name, double value) {
+        if (!lastRan) return;
+        results.back().counters.push_back({ name, value });
+        std::cout << "  " << std::left << std::setw(38) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << value << std::defaultfloat << std::endl;
+    }
+
+    bool Runner::WriteJson(const std::string& executable) const {
+        if (options.json.empty()) return true;
+
+        std::ofstream file(options.json);
+        if (!file.is_open()) {
+            std::cerr << "ERROR: Could not write benchmark results: " << options.json << std::endl;
+            return false;
+        }
+
+        char date[32] = {};
+        std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+        file << std::fixed << std::setprecision(3);
+        file << "{\n";
+        file << "  \"context\": {\n";
+        file << "    \"date\": " << jsonString(date) << ",\n";
+        file << "    \"executable\": " << jsonString(executable) << ",\n";
+        file << "    \"compiler\": " << jsonString(compilerName()) << ",\n";
+#ifdef NDEBUG
+        file << "    \"build_type\": \"release\",\n";
+#else
+        file << "    \"build_type\": \"debug\",\n";
+#endif
+        file << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+        file << "    \"min_sample_ms\": " << options.minSampleMs << ",\n";
+        file << "    \"samples\": " << options.samples << "\n";
+        file << "  },\n";
+
+        file << "  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result& r = results[i];
+            file << "    { \"name\": " << jsonString(r.name) << ", \"iterations\": " << r.iterations
+                 << ", \"samples\": " << r.samples << ", \"ns_per_op\": " << r.nsPerOp
+                 << ", \"min_ns\": " << r.minNs << ", \"max_ns\": " << r.maxNs
+                 << ", \"items_per_second\": " << r.itemsPerSecond;
+            for (const auto& [counter, value] : r.counters) file << ", " << jsonString(counter) << ": " << value;
+            file << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        file << "  ]\n";
+        file << "}\n";
+
+        std::cout << "Benchmark results written to: " << options.json << std::endl;
+        return bool(file);
+    }
+}
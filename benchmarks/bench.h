@@ -0,0 +1,77 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ============================================================================
+// MICROBENCHMARK HARNESS
+// ============================================================================
+// Each case is a body that runs its operation a given number of times. The
+// runner doubles that number until one sample takes at least minSampleMs,
+// then takes a number of samples and keeps the median, fastest and slowest
+// time per operation. The median is the figure to compare between commits.
+//
+// Results print as a table and, when asked, are written as JSON:
+//   { "context": { date, executable, compiler, build_type, num_cpus, ... },
+//     "benchmarks": [ { name, iterations, samples, ns_per_op, min_ns,
+//                       max_ns, items_per_second, <counters> }, ... ] }
+// Counters are figures a case reports besides its time, like bytes held.
+namespace Bench {
+	using Clock = std::chrono::steady_clock;
+
+	// Stops the optimiser from deleting work whose result is never used
+	template <typename T>
+	inline void KeepAlive(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r"(&value) : "memory");
+#else
+		static const void* volatile sink;
+		sink = &value;
+#endif
+	}
+
+	struct Options {
+		double minSampleMs = 20.0;
+		int samples = 9;
+		std::string filter;         // Only cases whose name contains this
+		std::string json;           // Where to write the results, none when empty
+	};
+
+	struct Result {
+		std::string name;
+		uint64_t iterations = 0;    // Per sample
+		int samples = 0;
+		double nsPerOp = 0.0;       // Median sample
+		double minNs = 0.0;
+		double maxNs = 0.0;
+		double itemsPerSecond = 0.0;
+		std::vector<std::pair<std::string, double>> counters;
+	};
+
+	class Runner {
+	public:
+		using Body = std::function<void(uint64_t iterations)>;
+
+		explicit Runner(const Options& options) : options(options) {}
+
+		// itemsPerOp turns the median into a throughput (pixels, pairs tested, ...); 0 leaves it out
+		void Run(const std::string& name, const Body& body, double itemsPerOp = 0.0);
+
+		// A case that could not run here (a missing file, say) is listed, not timed
+		void Skip(const std::string& name, const std::string& reason);
+
+		// Attaches a counter to the case just run; dropped if the filter skipped it
+		void Counter(const std::string& name, double value);
+
+		bool WriteJson(const std::string& executable) const;
+		const std::vector<Result>& GetResults() const { return results; }
+
+	private:
+		Options options;
+		std::vector<Result> results;
+		bool lastRan = false;
+	};
+}
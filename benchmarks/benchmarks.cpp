@@ -0,0 +1,368 @@
+// ============================================================================
+// OPERATION STARFALL MICROBENCHMARKS
+// ============================================================================
+// Times the engine and game code a frame leans on: Draw in every pixel mode,
+// the fill/string/sprite primitives, decal submission, bullet-vs-asteroid
+// collision, spawn/cleanup churn, PNG decode, the audio mix with and
+// without a noise callback, and story music loaded streamed and decoded.
+// Runs under the headless renderer and a Manual
+// mode audio engine, so it needs no window or sound card and gives the same
+// numbers on a build box.
+//
+// Visual Studio: build the Operation_Starfall_Bench project (Release).
+// Linux, from the repository root:
+//   g++ -std=c++17 -O2 -DNDEBUG -DOLC_PGE_HEADLESS -DOLC_IMAGE_LIBPNG -I.
+//       benchmarks/benchmarks.cpp benchmarks/bench.cpp src/asteroid.cpp
+//       src/rng.cpp src/snapshot.cpp -lpng -lpthread -ldl -lm -o starfall_bench
+//   ./starfall_bench --json bench.json
+//
+// Run from the repository root so the sprite decode cases find assets/.
+// Options: --filter text (only cases whose name contains it), --json file,
+// --samples n, --min-ms ms (shortest sample; raise it on a noisy machine).
+#define OLC_PGE_APPLICATION
+#include "olcPixelGameEngine.h"
+#define OLC_PGEX_MINIAUDIO
+#include "olcPGEX_MiniAudio.h"
+
+#include "src/GameConfig.h"
+#include "src/asteroid.h"
+#include "src/bullet.h"
+#include "src/collision.h"
+#include "src/rng.h"
+#include "bench.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Fixed so every run lays out the same scenes
+constexpr uint64_t BENCH_SEED = 1;
+
+class BenchmarkRunner : public olc::PixelGameEngine {
+public:
+    Bench::Runner runner;
+    std::string executable;
+    bool failed = false;
+
+    std::unique_ptr<olc::Sprite> opaqueSprite;
+    std::unique_ptr<olc::Sprite> maskedSprite;
+    std::unique_ptr<olc::Sprite> bulletSprite;
+    std::unique_ptr<olc::Decal> bulletDecal;
+
+    // Mixes only when Render is called, so every block is timed on this thread
+    olc::MiniAudio audio{ olc::MiniAudio::DeviceMode::Manual };
+    float synthPhase = 0.0f;
+
+    BenchmarkRunner(const Bench::Options& options, const std::string& executable)
+        : runner(options), executable(executable) {
+        sAppName = "Operation Starfall Benchmarks";
+    }
+
+    bool OnUserCreate() override {
+        // Procedural so the drawing cases do not depend on the asset folder
+        opaqueSprite = std::make_unique<olc::Sprite>(64, 64);
+        maskedSprite = std::make_unique<olc::Sprite>(64, 64);
+        for (int y = 0; y < 64; y++) {
+            for (int x = 0; x < 64; x++) {
+                olc::Pixel p(uint8_t(x * 4), uint8_t(y * 4), 128);
+                opaqueSprite->SetPixel(x, y, p);
+                // A disc with a soft edge: transparent, blended and solid pixels
+                int d2 = (x - 32) * (x - 32) + (y - 32) * (y - 32);
+                p.a = d2 < 24 * 24 ? 255 : d2 < 30 * 30 ? 128 : 0;
+                maskedSprite->SetPixel(x, y, p);
+            }
+        }
+
+        bulletSprite = std::make_unique<olc::Sprite>(8, 8);
+        for (int y = 0; y < 8; y++)
+            for (int x = 0; x < 8; x++)
+                bulletSprite->SetPixel(x, y, olc::YELLOW);
+        bulletDecal = std::make_unique<olc::Decal>(bulletSprite.get());
+        return true;
+    }
+
+    bool OnUserUpdate(float) override {
+        benchDraw();
+        benchPrimitives();
+        benchDecals();
+        benchCollision();
+        benchChurn();
+        benchDecode();
+        benchAudioMix();
+        benchMusicLoad();
+
+        SetPixelMode(olc::Pixel::NORMAL);
+        if (!runner.WriteJson(executable)) failed = true;
+        return false;
+    }
+
+    // ===== PIXEL PLOTTING =====
+    void benchDraw() {
+        const int size = 256;
+        auto plot = [this, size](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                for (int y = 0; y < size; y++)
+                    for (int x = 0; x < size; x++)
+                        Draw(x, y, olc::Pixel(uint8_t(x), uint8_t(y), uint8_t(i), 160));
+            }
+            keepAliveTarget();
+        };
+
+        SetPixelMode(olc::Pixel::NORMAL);
+        runner.Run("draw/normal", plot, size * size);
+        SetPixelMode(olc::Pixel::MASK);
+        runner.Run("draw/mask", plot, size * size);
+        SetPixelMode(olc::Pixel::ALPHA);
+        runner.Run("draw/alpha", plot, size * size);
+        // Additive, like a glow pass would use
+        SetPixelMode([](const int, const int, const olc::Pixel& src, const olc::Pixel& dst) {
+            return olc::Pixel(uint8_t(std::min(src.r + dst.r, 255)), uint8_t(std::min(src.g + dst.g, 255)),
+                              uint8_t(std::min(src.b + dst.b, 255)));
+        });
+        runner.Run("draw/custom", plot, size * size);
+        SetPixelMode(olc::Pixel::NORMAL);
+    }
+
+    // ===== PRIMITIVES =====
+    void benchPrimitives() {
+        runner.Run("fill_rect/220x140", [this](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++)
+                FillRect(20 + int(i & 15), 20, 220, 140, olc::DARK_BLUE);
+            keepAliveTarget();
+        }, 220 * 140);
+
+        runner.Run("fill_circle/r40", [this](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++)
+                FillCircle(300 + int(i & 15), 200, 40, olc::YELLOW);
+            keepAliveTarget();
+        });
+
+        const std::string hud = "SCORE: 0012345   LIVES: 3   LEVEL 2";
+        runner.Run("draw_string/hud", [this, &hud](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++)
+                DrawString(10, 10 + int(i & 7), hud, olc::WHITE);
+            keepAliveTarget();
+        }, double(hud.size()));
+
+        runner.Run("draw_sprite/64x64_opaque", [this](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++)
+                DrawSprite(100 + int(i & 15), 300, opaqueSprite.get());
+            keepAliveTarget();
+        }, 64 * 64);
+
+        // The game's own path for sprites with transparency
+        SetPixelMode(olc::Pixel::ALPHA);
+        runner.Run("draw_sprite/64x64_alpha", [this](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++)
+                DrawSprite(100 + int(i & 15), 300, maskedSprite.get());
+            keepAliveTarget();
+        }, 64 * 64);
+        SetPixelMode(olc::Pixel::NORMAL);
+    }
+
+    // ===== DECAL SUBMISSION =====
+    // Each operation is one frame's worth of bullet decals; the layer's list is
+    // cleared afterwards as the renderer would after drawing it
+    void benchDecals() {
+        const int perFrame = 100;
+        runner.Run("draw_decal/100_per_frame", [this, perFrame](uint64_t iterations) {
+            auto& instances = GetLayers()[0].vecDecalInstance;
+            for (uint64_t i = 0; i < iterations; i++) {
+                for (int d = 0; d < perFrame; d++)
+                    DrawDecal({ float(d * 8), float(d & 31) * 16.0f }, bulletDecal.get(), { 0.5f, 0.5f });
+                Bench::KeepAlive(instances.back());
+                instances.clear();
+            }
+        }, perFrame);
+    }
+
+    // ===== COLLISION =====
+    // The game's bullet-vs-asteroid pass. A hit only counts, so every
+    // iteration tests the same layout instead of an emptying field.
+    void benchCollision() {
+        for (int n : { 16, 64, 256 }) {
+            Rng rng(BENCH_SEED, 0);
+            std::vector<Bullet> bullets(n);
+            std::vector<Asteroid> asteroids(n);
+            for (auto& b : bullets) b.pos = { rng.Range(0.0f, 900.0f), rng.Range(0.0f, 600.0f) };
+            for (auto& a : asteroids) {
+                a.pos = { rng.Range(0.0f, 900.0f), rng.Range(0.0f, 600.0f) };
+                a.r = rng.Range(24.0f, 40.0f);
+            }
+
+            runner.Run("collision/bullets_vs_asteroids_" + std::to_string(n), [&](uint64_t iterations) {
+                int hits = 0;
+                for (uint64_t i = 0; i < iterations; i++)
+                    CollideShots(bullets, asteroids, [&hits](Bullet&, Asteroid&) { hits++; });
+                Bench::KeepAlive(hits);
+            }, double(n) * n);
+        }
+    }
+
+    // ===== SPAWN / CLEANUP CHURN =====
+    // One operation is one frame: spawn a bullet and an asteroid the way the
+    // game does, move everything, and erase what left the screen. Populations
+    // settle at the size a busy level reaches.
+    void benchChurn() {
+        Rng rng(BENCH_SEED, 1);
+        std::vector<Bullet> bullets;
+        std::vector<Asteroid> asteroids;
+        bullets.reserve(GameConfig::RESERVE_BULLETS);
+        asteroids.reserve(GameConfig::RESERVE_ASTEROIDS);
+        const float dt = 1.0f / 60.0f;
+
+        runner.Run("churn/spawn_update_cleanup", [&](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++) {
+                Bullet b;
+                b.pos = { rng.Range(10.0f, 890.0f), 560.0f };
+                b.vel = { 0.0f, -GameConfig::PLAYER_BULLET_SPEED };
+                b.r = 4.0f;
+                bullets.push_back(b);
+
+                float u[4];
+                rng.FillUniform(u, 4);
+                Asteroid a;
+                a.pos = { Rng::Lerp(10.0f, 890.0f, u[0]), -30.0f };
+                a.vel = { Rng::Lerp(-20.0f, 20.0f, u[1]), Rng::Lerp(80.0f, 150.0f, u[2]) };
+                a.r = Rng::Lerp(24.0f, 40.0f, u[3]);
+                asteroids.push_back(a);
+
+                for (auto& x : bullets) x.Update(dt);
+                for (auto& x : asteroids) x.Update(dt, 600);
+
+                bullets.erase(std::remove_if(bullets.begin(), bullets.end(),
+                    [](const Bullet& x) { return !x.alive; }), bullets.end());
+                asteroids.erase(std::remove_if(asteroids.begin(), asteroids.end(),
+                    [](const Asteroid& x) { return !x.alive; }), asteroids.end());
+            }
+            Bench::KeepAlive(bullets.size());
+            Bench::KeepAlive(asteroids.size());
+        });
+    }
+
+    // ===== SPRITE DECODE =====
+    void benchDecode() {
+        for (const char* file : { "asteroid.png", "bg_space.png" }) {
+            const std::string name = std::string("sprite_decode/") + file;
+            const std::string path = std::string("assets/sprites/") + file;
+
+            if (!std::ifstream(path).good()) {
+                runner.Skip(name, "missing " + path);
+                continue;
+            }
+            olc::Sprite probe;
+            if (probe.LoadFromFile(path) != olc::rcode::OK) {
+                runner.Skip(name, "no image loader in this build");
+                continue;
+            }
+
+            runner.Run(name, [&path](uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; i++) {
+                    olc::Sprite sprite;
+                    sprite.LoadFromFile(path);
+                    Bench::KeepAlive(sprite.width);
+                }
+            }, double(probe.width) * probe.height);
+        }
+    }
+
+    // ===== AUDIO MIX =====
+    // One operation is one device period through the mix the audio callback runs:
+    // engine, waveforms, noise and clip. The noise cases generate the same sine,
+    // a block at a time and through the per-sample wrapper, and report what the
+    // callback alone cost per block.
+    void benchAudioMix() {
+        const ma_uint32 period = audio.GetDeviceSettings().m_period_size_in_frames;
+        const std::string frames = std::to_string(period);
+        auto render = [this, period](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; i++)
+                audio.Render(period);
+        };
+
+        audio.ClearNoiseCallback();
+        runner.Run("audio_mix/silent_" + frames, render, period);
+
+        audio.SetNoiseBlockCallback([this](float* buffer, const ma_uint32 frameCount, const ma_uint32 channels, const ma_uint32 sampleRate) {
+            const float step = 2.0f * 3.14159265f * 440.0f / float(sampleRate);
+            for (ma_uint32 i = 0; i < frameCount; i++) {
+                float sample = 0.2f * std::sin(synthPhase);
+                synthPhase = std::fmod(synthPhase + step, 2.0f * 3.14159265f);
+                for (ma_uint32 c = 0; c < channels; c++) buffer[i * channels + c] = sample;
+            }
+        });
+        runner.Run("audio_mix/noise_block_" + frames, render, period);
+        runner.Counter("callback_ns_per_block", audio.GetNoiseCallbackTiming().m_average_us * 1000.0);
+
+        audio.SetNoiseCallback([this](float& left, float& right, const float sampleTime) {
+            left = right = 0.2f * std::sin(synthPhase);
+            synthPhase = std::fmod(synthPhase + 2.0f * 3.14159265f * 440.0f * sampleTime, 2.0f * 3.14159265f);
+        });
+        runner.Run("audio_mix/noise_per_sample_" + frames, render, period);
+        runner.Counter("callback_ns_per_block", audio.GetNoiseCallbackTiming().m_average_us * 1000.0);
+
+        audio.ClearNoiseCallback();
+    }
+
+    // ===== MUSIC LOAD =====
+    // The story music the game streams, loaded both ways. The time is the
+    // call on this thread (a decoded sound finishes decoding on miniaudio's
+    // job thread), and resident_bytes is the decoded audio each keeps in memory.
+    void benchMusicLoad() {
+        const std::string path = "assets/audio/story_epic.wav";
+        for (bool stream : { true, false }) {
+            const std::string name = std::string("music_load/") + (stream ? "streamed" : "decoded") + "/story_epic.wav";
+            if (!std::ifstream(path).good()) {
+                runner.Skip(name, "missing " + path);
+                continue;
+            }
+
+            uint64_t resident = 0;
+            runner.Run(name, [this, &path, stream, &resident](uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; i++) {
+                    int id = stream ? audio.LoadStream(path) : audio.LoadSound(path);
+                    resident = audio.GetResidentBytes(id);
+                    audio.UnloadSound(id);
+                }
+            });
+            runner.Counter("resident_bytes", double(resident));
+        }
+    }
+
+    void keepAliveTarget() {
+        Bench::KeepAlive(*GetDrawTarget()->GetData());
+    }
+};
+
+static bool parseBenchOptions(int argc, char** argv, Bench::Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--filter" && hasValue) options.filter = argv[++i];
+        else if (arg == "--json" && hasValue) options.json = argv[++i];
+        else if (arg == "--samples" && hasValue) options.samples = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--min-ms" && hasValue) options.minSampleMs = std::atof(argv[++i]);
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--filter text] [--json file] [--samples n] [--min-ms ms]" << std::endl;
+            return false;
+        }
+    }
+    return options.minSampleMs > 0.0;
+}
+
+int main(int argc, char** argv)
+{
+    Bench::Options options;
+    if (!parseBenchOptions(argc, argv, options))
+        return 2;
+
+    BenchmarkRunner bench(options, argv[0]);
+    if (bench.Construct(900, 600, 1, 1))
+        bench.Start();
+    return bench.failed ? 1 : 0;
+}
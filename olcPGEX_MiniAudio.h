@@ -69,17 +69,39 @@
 #include "miniaudio.h"
 #pragma warning(pop)
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <exception>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
 #undef DEVICE_TYPE //Stupid Windows
 
+/**
+ * optional tracing hooks, define them before including this file to put the
+ * audio thread and the blocking loads on a profiler's timeline
+ *
+ *  PGEX_MA_TRACE_SCOPE(name, detail)   times the rest of the enclosing block,
+ *                                      name is a literal, detail a c string or null
+ *  PGEX_MA_TRACE_THREAD(name)          labels the calling thread, called often
+ */
+#ifndef PGEX_MA_TRACE_SCOPE
+#define PGEX_MA_TRACE_SCOPE(name, detail)
+#endif
+#ifndef PGEX_MA_TRACE_THREAD
+#define PGEX_MA_TRACE_THREAD(name)
+#endif
+
 namespace olc
 {
     
@@ -94,17 +116,61 @@ namespace olc
             SoundFileBuffer();
             SoundFileBuffer(ma_engine* engine);
             ~SoundFileBuffer();
+            // moved rather than copied, the resource manager keeps pointers into the data
+            SoundFileBuffer(SoundFileBuffer&&) = default;
+            SoundFileBuffer& operator=(SoundFileBuffer&&) = default;
 
             bool Load(const std::string& path, olc::ResourcePack* pack = nullptr);
+            // takes already decoded f32 pcm, registered under name instead of a file path
+            bool LoadPcm(const std::string& name, std::vector<float>&& pcm, const ma_uint32 channels, const ma_uint32 sampleRate);
             void Unload();
+            // unregisters the data whatever the count, once every sound counted has moved off it
+            void Release();
 
             std::vector<char> m_buffer;
+            std::vector<float> m_pcm;
+            ma_uint32 m_pcm_channels = 0;
+            ma_uint32 m_pcm_sample_rate = 0;
             int m_count = 0;
             ma_engine* m_engine;
             bool m_loaded = false;
+            bool m_from_file = false;   // false for pcm handed over by LoadSoundFromPcm
+            // the name registered with the resource manager, the path with a suffix once reloaded
             std::string m_path;
         };
+
+        // a whole sound decoded to interleaved f32, at its own channel count and sample rate
+        struct DecodedSound
+        {
+            std::vector<float> m_pcm;
+            ma_uint32 m_channels = 0;
+            ma_uint32 m_sample_rate = 0;
+        };
         
+        // which busy voice PlayVoice takes over when every voice in a pool is playing
+        enum class VoiceSteal
+        {
+            Oldest,     // the voice that started longest ago
+            Quietest    // the voice with the lowest volume, oldest first on a tie
+        };
+
+        struct VoiceStats
+        {
+            int m_voices = 0;           // size of the pool
+            int m_active = 0;           // voices playing right now
+            int m_peak_active = 0;      // most voices ever playing at once
+            ma_uint64 m_plays = 0;      // total PlayVoice calls
+            ma_uint64 m_steals = 0;     // plays that had to cut off a busy voice
+        };
+
+        struct Voice
+        {
+            ma_sound m_sound;
+            ma_uint64 m_started = 0;    // play number this voice last started on
+            float m_volume = 0.0f;
+            int m_emitter = -1;         // emitter whose pan and gain the voice follows, -1 for none
+        };
+
         struct Sound
         {
             ma_sound m_sound;
@@ -112,15 +178,90 @@ namespace olc
             float m_length_in_seconds = 0;
             std::string m_path;
             bool m_play_once = false;
+            bool m_streamed = false;
+            bool m_file_buffered = true;
+
+            /**
+             * optional pool of copies sharing m_sound's decoded data, voices
+             * are heap allocated because miniaudio's node graph keeps
+             * pointers to them
+             */
+            std::vector<std::unique_ptr<Voice>> m_voices;
+            VoiceSteal m_voice_steal = VoiceSteal::Oldest;
+            size_t m_next_voice = 0;
+            VoiceStats m_voice_stats;
+
+            /**
+             * play once bookkeeping, the end callback links finished
+             * sounds into the owner's lock-free completion list
+             */
+            int m_id = -1;
+            MiniAudio* m_owner = nullptr;
+            std::atomic<bool> m_finished{false};
+            Sound* m_next_finished = nullptr;
             
             const std::string string();
         };
 
+        struct InitTimings
+        {
+            double m_device_ms = 0.0;
+            double m_resource_manager_ms = 0.0;
+            double m_engine_ms = 0.0;
+        };
+
+        // per block cost of the noise callback, in microseconds
+        struct CallbackTiming
+        {
+            ma_uint64 m_blocks = 0;
+            double m_average_us = 0.0;
+            double m_max_us = 0.0;
+        };
+
+        // where the mixed output goes
+        enum class DeviceMode
+        {
+            Hardware,   // a real playback device, falls back to Null when none can be opened
+            Null,       // no device, a background thread pulls the engine one period at a time, in real time
+            Manual      // no device, nothing is mixed until Render is called, for tests and benchmarks
+        };
+
+        // how the output is set up, zeroes leave the choice to miniaudio and the backend
+        struct DeviceSettings
+        {
+            DeviceMode m_mode = DeviceMode::Hardware;
+            ma_uint32 m_sample_rate = 48000;
+            ma_uint32 m_period_size_in_frames = 0;  // frames mixed per callback, 0 is miniaudio's low latency default
+            ma_uint32 m_periods = 0;                // periods the device buffers, 0 is the backend's default
+        };
+
+        // time from a play call to the start of the callback that first renders it, in milliseconds
+        struct LatencyStats
+        {
+            ma_uint64 m_samples = 0;
+            double m_p50_ms = 0.0;
+            double m_p90_ms = 0.0;
+            double m_p99_ms = 0.0;
+            double m_max_ms = 0.0;
+            double m_buffer_ms = 0.0;   // plus roughly this much queued in the device before it's heard
+        };
+
+        // what the device-less modes have mixed since the last reset
+        struct RenderStats
+        {
+            ma_uint64 m_frames = 0;             // frames mixed
+            ma_uint64 m_clipped_samples = 0;    // samples outside -1.0f..1.0f before clipping
+            float m_peak = 0.0f;                // loudest sample before clipping
+        };
+
+        using NoiseBlockCallback = std::function<void(float* buffer, const ma_uint32 frameCount, const ma_uint32 channels, const ma_uint32 sampleRate)>;
+
         class Waveform
         {
         public:
             Waveform();
             Waveform(const double amplitude, const double frequency, const ma_waveform_type waveformType);
+            Waveform(const double amplitude, const double frequency, const ma_waveform_type waveformType, const ma_uint32 sampleRate);
             
             void Start();
             void Stop();
@@ -140,7 +281,8 @@ namespace olc
         };
 
     public:
-        MiniAudio();
+        MiniAudio(const DeviceMode mode = DeviceMode::Hardware);
+        MiniAudio(const DeviceSettings& settings);
         ~MiniAudio();
         virtual bool OnBeforeUserUpdate(float& fElapsedTime) override;
         static void data_callback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount);
@@ -153,13 +295,55 @@ namespace olc
         static std::function<void(float& out_data_channel_left, float& out_data_channel_right, const float fElapsedTime)> m_noise_callback;
         static float m_noise_left_channel;
         static float m_noise_right_channel;
+        static NoiseBlockCallback m_noise_block_callback;
+        static std::vector<float> m_noise_buffer;
 
     public: // configuration
         void SetBackgroundPlay(const bool state);
 
+    public: // device configuration and latency
+        // the settings in effect, with the period size, period count and sample rate the device actually got
+        const DeviceSettings& GetDeviceSettings() const;
+        // stamps every Play and PlayVoice call and measures when the audio thread first mixes it
+        void SetLatencyProbe(const bool enabled);
+        // plays are stamped with this time rather than when they're called, until it's set back to a default time_point.
+        // for a queue that applies plays on its own thread, so the probe counts from when they were asked for
+        void SetPlayRequestTime(const std::chrono::steady_clock::time_point& requested);
+        // percentiles over the last 4096 measurements
+        LatencyStats GetLatencyStats() const;
+        void ResetLatencyStats();
+
+    public: // device-less output, Null and Manual modes
+        // the mode in use, Null if Hardware was asked for but no device could be opened
+        DeviceMode GetDeviceMode() const;
+        // Manual mode: mixes frameCount frames, into output (interleaved stereo) if it isn't null
+        void Render(const ma_uint64 frameCount, float* output = nullptr);
+        // writes everything mixed from now on to a 32-bit float stereo WAV, not available in Hardware mode
+        bool StartRecording(const std::string& path);
+        void StopRecording();
+        bool IsRecording();
+        RenderStats GetRenderStats();
+        void ResetRenderStats();
+
     public: // loading routines
         const int LoadSound(const std::string& path, olc::ResourcePack* pack = nullptr, bool playOnce = false);
+        // loads a sound from interleaved f32 pcm already in memory, e.g. synthesised, name stands in for its path
+        const int LoadSoundFromPcm(const std::string& name, std::vector<float> pcm, const ma_uint32 channels, const ma_uint32 sampleRate);
+        // loads a sound which is decoded incrementally during playback, intended for long music tracks
+        const int LoadStream(const std::string& path, olc::ResourcePack* pack = nullptr);
+        // decodes a whole file, touching no engine state so any thread can call it, e.g. a file watcher
+        static bool DecodeFile(const std::string& path, DecodedSound& out, olc::ResourcePack* pack = nullptr);
+        // re-reads a sound from its file, keeping its id, volume, pan, pitch and playback state.
+        // a loaded sound is decoded here and then swapped in as ReplaceSoundData does
+        void ReloadSound(const int id, olc::ResourcePack* pack = nullptr);
+        // swaps pcm decoded elsewhere into a loaded sound and every other sound loaded from the same file,
+        // keeping their ids, settings, playback state and voice pools. returns how many sounds were swapped
+        int ReplaceSoundData(const int id, DecodedSound&& decoded);
         void UnloadSound(const int id);
+        // unloads the play once sounds which have finished, done before every OnUserUpdate by default
+        void ReapFinishedSounds();
+        // turn the per frame reaping off when another thread owns playback, it then calls ReapFinishedSounds itself
+        void SetReapOnUpdate(const bool enabled);
     
     public: // playback routines
         // plays a sample, can be set to loop
@@ -173,6 +357,32 @@ namespace olc
         // toggle between play and pause
         void Toggle(const int id);
 
+    public: // scheduled playback, times are absolute engine times in pcm frames
+        // the engine's current time, the clock scheduled starts, stops and fades run on
+        ma_uint64 GetEngineTimeInPcmFrames();
+        // starts a sound from the beginning at startTime, fading from silence up to its volume over fadeFrames.
+        // a sound that's still playing (e.g. fading out) fades back up from where it is instead
+        void PlayWithFadeIn(const int id, const ma_uint64 startTime, const ma_uint64 fadeFrames, const bool looping = false);
+        // fades a sound down to silence from startTime over fadeFrames, then stops it
+        void StopWithFadeOut(const int id, const ma_uint64 startTime, const ma_uint64 fadeFrames);
+
+    public: // voice pools
+        // gives a loaded (not streamed) sound a pool of voices sharing its decoded data, so overlapping plays layer
+        void CreateVoicePool(const int id, const int voices, const VoiceSteal steal = VoiceSteal::Oldest);
+        // plays a sound on the next free voice in its pool, stealing a busy one if needed, returns the voice index
+        int PlayVoice(const int id, const float volume = 1.0f, const float pan = 0.0f, const float pitch = 1.0f);
+        // plays like PlayVoice, then keeps following the emitter's pan and gain until the voice is reused
+        int PlayVoiceAt(const int id, const int emitter, const float volume = 1.0f, const float pitch = 1.0f);
+        // moves an emitter, voices already following it only change on the next UpdateEmitters
+        void SetEmitter(const int emitter, const float pan, const float gain);
+        // applies every emitter to the playing voices following it, one pass over all pools,
+        // each voice's volume being the one it was played at times its emitter's gain
+        void UpdateEmitters();
+        // stops every voice in a sound's pool
+        void StopVoices(const int id);
+        // voice usage of a sound's pool, m_active is sampled at the time of the call
+        VoiceStats GetVoiceStats(const int id);
+
     public: // seeking controls
         // seek to the provided position in the sound, by milliseconds
         void Seek(const int id, const ma_uint64 milliseconds);
@@ -200,6 +410,8 @@ namespace olc
         float GetCursorFloat(const int id);
         // get the current number of active "one off" sounds 
         int GetOneOffCount();
+        // estimate of the decoded pcm memory held by a sound, in bytes
+        ma_uint64 GetResidentBytes(const int id);
 
     public: // waveforms
         // creates a new waveform and returns the id of the waveform
@@ -247,21 +459,80 @@ namespace olc
          * previously used wil be played.
          */
         void SetNoiseCallback(std::function<void(float& noiseLeftChannel, float& noiseRightChannel, const float fElapsedTime)>callbackFunc);
+        
+        /**
+         * set a noise callback which generates a whole block of
+         * audio per call, rather than one sample frame at a time.
+         * 
+         * the buffer is interleaved, frameCount * channels floats
+         * long, and starts out silent. whatever you write to it is
+         * mixed into the output. it runs on the audio thread, so
+         * don't allocate, lock or block in it.
+         * 
+         * SetNoiseCallback is a wrapper around this one.
+         */
+        void SetNoiseBlockCallback(NoiseBlockCallback callbackFunc);
         // clears the noise callback and resets the channel values to 0.0
         void ClearNoiseCallback();
+        // how long the noise callback has taken per block since the last reset
+        CallbackTiming GetNoiseCallbackTiming() const;
+        void ResetNoiseCallbackTiming();
+
+    public: // mixing helpers, vectorised where the cpu allows
+        // dst[i] += src[i], for count samples
+        static void MixAdd(float* dst, const float* src, const size_t count);
+        // dst[i] += src[i] * gain, for count samples
+        static void MixAddScaled(float* dst, const float* src, const float gain, const size_t count);
+        // buffer[i] *= gain, for count samples
+        static void ApplyGain(float* buffer, const float gain, const size_t count);
+        // dst[i] = clamp(src[i], -1.0f, 1.0f), for count samples, dst may be src
+        static void Clip(float* dst, const float* src, const size_t count);
 
     public: // advanced features
+        // nullptr unless the mode is Hardware
         ma_device* GetDevice();
         ma_engine* GetEngine();
         ma_resource_manager* GetResourceManager();
         ma_sound* GetSound(const int id);
+        // how long each stage of the constructor took, in milliseconds
+        const InitTimings& GetInitTimings() const;
 
     private:
         const int find_or_create_empty_sound_slot();
+        void init_voice_pool(Sound* sound, const int voices);
+        // re-creates a sound, and its voice pool, from the data registered under name, keeping its settings
+        void reinit_sound(Sound* sound, const std::string& name, const ma_uint32 flags);
+        void uninit_voice_pool(Sound* sound);
+        // end callback of play once sounds, runs on the audio thread
+        static void on_play_once_end(void* pUserData, ma_sound* pSound);
+        // lock-free push onto m_finished_sounds, safe from any thread, once per sound
+        void push_finished(Sound* sound);
+        // takes a sound back out of m_finished_sounds before it's deleted
+        void remove_finished(Sound* sound);
+        // mixes up to one device period of everything into output, called from data_callback
+        void mix_block(float* output, const ma_uint32 frameCount);
+        // mixes frameCount frames without a device, measuring clipping and recording, any length
+        void render_offline(ma_uint64 frameCount, float* output);
+        // Null mode's stand-in for the device thread
+        void null_device_loop();
+        // records a play for the latency probe, at the time set by SetPlayRequestTime if there is one
+        void stamp_latency_probe();
+        // turns the stamps left since the last block into measurements, audio thread only
+        void collect_latency_probe();
 
     private:
+        DeviceSettings m_settings;
         ma_device m_device;
         ma_device_config m_device_config;
+
+        std::thread m_null_thread;
+        std::atomic<bool> m_null_running{false};
+        std::vector<float> m_render_buffer;
+        // guards the encoder and render stats, only ever taken off the hardware audio thread
+        std::mutex m_render_mutex;
+        ma_encoder m_encoder;
+        bool m_recording = false;
+        RenderStats m_render_stats;
         
         ma_resource_manager m_resource_manager;
         ma_resource_manager_config m_resource_manager_config;
@@ -270,10 +541,45 @@ namespace olc
         ma_engine_config m_engine_config;
         
         bool m_initialized = false;
+        InitTimings m_init_timings;
         int m_count_play_once_sounds = 0;
+        // gives each reloaded sound file buffer a name of its own
+        int m_count_reloads = 0;
         std::vector<Sound*> m_sounds;
+        // slots emptied by UnloadSound, reused last in first out
+        std::vector<int> m_free_slots;
+        // play once sounds which have finished, pushed by the audio thread, drained by ReapFinishedSounds
+        std::atomic<Sound*> m_finished_sounds{nullptr};
+        std::atomic<bool> m_reap_on_update{true};
+
+        std::atomic<ma_uint64> m_noise_blocks{0};
+        std::atomic<ma_uint64> m_noise_total_ns{0};
+        std::atomic<ma_uint64> m_noise_max_ns{0};
         
+        /**
+         * latency probe, play calls claim a slot for their timestamp,
+         * the audio thread empties slots and appends to m_latency_samples
+         */
+        static constexpr size_t LATENCY_STAMPS = 64;
+        static constexpr size_t LATENCY_SAMPLES = 4096;
+        std::atomic<bool> m_latency_probe{false};
+        std::atomic<ma_uint64> m_latency_stamp_head{0};
+        ma_uint64 m_latency_stamp_tail = 0;
+        std::atomic<ma_int64> m_latency_stamps[LATENCY_STAMPS] = {};
+        ma_int64 m_play_requested = 0;  // nanoseconds, 0 stamps the play call itself
+        std::atomic<ma_uint32> m_latency_samples[LATENCY_SAMPLES] = {};  // microseconds
+        std::atomic<ma_uint64> m_latency_count{0};
+
         std::unordered_map<std::string, SoundFileBuffer> m_sound_file_buffers;
+
+        struct Emitter
+        {
+            float m_pan = 0.0f;
+            float m_gain = 1.0f;
+        };
+        
+        // indexed by emitter, grows to the highest one SetEmitter has seen
+        std::vector<Emitter> m_emitters;
     };
 }
 
@@ -285,6 +591,18 @@ static constexpr ma_format      DEVICE_FORMAT       = ma_format_f32;
 static constexpr int            DEVICE_SAMPLE_RATE  = 48000;
 static constexpr ma_device_type DEVICE_TYPE         = ma_device_type_playback;
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PGEX_MA_SSE2
+#include <emmintrin.h>
+#if defined(__AVX__)
+#define PGEX_MA_AVX
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define PGEX_MA_NEON
+#include <arm_neon.h>
+#endif
+
 void PGEX_MA_LOG(const std::string_view& message = "")
 {
 #ifdef DEBUG
@@ -320,6 +638,8 @@ namespace olc
             return true;
         }
 
+        PGEX_MA_TRACE_SCOPE("sound file read", path.c_str());
+
         if(pack != nullptr)
         {
             PGEX_MA_LOG("loading sound file via olc::ResourcePack");
@@ -349,11 +669,38 @@ namespace olc
 
         m_count = 1;
         m_loaded = true;
+        m_from_file = true;
         m_path = path;
         
         return true;
     }
 
+    bool MiniAudio::SoundFileBuffer::LoadPcm(const std::string& name, std::vector<float>&& pcm, const ma_uint32 channels, const ma_uint32 sampleRate)
+    {
+        if(m_loaded)
+        {
+            m_count++;
+            PGEX_MA_LOG(std::string("reusing pcm buffer named: ") + m_path);
+            return true;
+        }
+
+        if(channels == 0 || pcm.size() < channels)
+            return false;
+
+        m_pcm = std::move(pcm);
+        m_pcm_channels = channels;
+        m_pcm_sample_rate = sampleRate;
+
+        if(ma_resource_manager_register_decoded_data(m_engine->pResourceManager, name.c_str(), m_pcm.data(), m_pcm.size() / channels, ma_format_f32, channels, sampleRate) != MA_SUCCESS)
+            return false;
+
+        m_count = 1;
+        m_loaded = true;
+        m_path = name;
+
+        return true;
+    }
+
     void MiniAudio::SoundFileBuffer::Unload()
     {
         if(!m_loaded)
@@ -364,14 +711,21 @@ namespace olc
         PGEX_MA_LOG(std::string("decreased count of: ") + m_path + " to " + std::to_string(m_count));
         
         if(m_count == 0)
-        {
-            if(ma_resource_manager_unregister_data(m_engine->pResourceManager, m_path.c_str()))
-                throw std::runtime_error{"failed to unregister data from the resource manager"};
+            Release();
+    }
 
-            m_loaded = false;
-            
-            PGEX_MA_LOG(std::string("unloaded sound file buffer with path: ") + m_path);
-        }
+    void MiniAudio::SoundFileBuffer::Release()
+    {
+        if(!m_loaded)
+            return;
+
+        if(ma_resource_manager_unregister_data(m_engine->pResourceManager, m_path.c_str()))
+            throw std::runtime_error{"failed to unregister data from the resource manager"};
+
+        m_count = 0;
+        m_loaded = false;
+        
+        PGEX_MA_LOG(std::string("unloaded sound file buffer with path: ") + m_path);
     }
 
 #pragma endregion
@@ -381,7 +735,7 @@ namespace olc
     const std::string MiniAudio::Sound::string()
     {
         std::ostringstream oss;
-        oss << m_path << ", frames(" << m_length_in_pcm_frames << ") seconds(" << m_length_in_seconds << ") play_once(" << m_play_once << ")";
+        oss << m_path << ", frames(" << m_length_in_pcm_frames << ") seconds(" << m_length_in_seconds << ") play_once(" << m_play_once << ") streamed(" << m_streamed << ")";
         return oss.str();
     }
 
@@ -393,11 +747,16 @@ namespace olc
     }
 
     MiniAudio::Waveform::Waveform(const double amplitude, const double frequency, const ma_waveform_type waveformType)
+        : Waveform(amplitude, frequency, waveformType, DEVICE_SAMPLE_RATE)
+    {
+    }
+
+    MiniAudio::Waveform::Waveform(const double amplitude, const double frequency, const ma_waveform_type waveformType, const ma_uint32 sampleRate)
     {
         m_waveform_config = ma_waveform_config_init(
             DEVICE_FORMAT,
             DEVICE_CHANNELS,
-            DEVICE_SAMPLE_RATE,
+            sampleRate,
             waveformType,
             amplitude,
             frequency
@@ -451,45 +810,154 @@ namespace olc
     std::function<void(float& out_audio_data_left, float& out_audio_data_right, const float fElapsedTime)> MiniAudio::m_noise_callback;
     float MiniAudio::m_noise_left_channel = 0.0f;
     float MiniAudio::m_noise_right_channel = 0.0f;
+    MiniAudio::NoiseBlockCallback MiniAudio::m_noise_block_callback;
+    std::vector<float> MiniAudio::m_noise_buffer;
+
+    MiniAudio::MiniAudio(const DeviceMode mode) : MiniAudio(DeviceSettings{ mode })
+    {
+    }
 
-    MiniAudio::MiniAudio() : olc::PGEX(true)
+    MiniAudio::MiniAudio(const DeviceSettings& settings) : olc::PGEX(true), m_settings(settings)
     {
+        using clock = std::chrono::steady_clock;
+        auto elapsed_ms = [](clock::time_point since) { return std::chrono::duration<double, std::milli>(clock::now() - since).count(); };
+        
+        clock::time_point stage_start = clock::now();
+
+        PGEX_MA_TRACE_SCOPE("MiniAudio init", nullptr);
+
+        /**
+         * every position and latency conversion divides by the rate,
+         * 0 means miniaudio's default rather than "no rate"
+         */
+        if(m_settings.m_sample_rate == 0)
+            m_settings.m_sample_rate = MA_DEFAULT_SAMPLE_RATE;
+
         m_device_config = ma_device_config_init(DEVICE_TYPE);
         m_device_config.playback.format = DEVICE_FORMAT;
         m_device_config.playback.channels = DEVICE_CHANNELS;
-        m_device_config.sampleRate = DEVICE_SAMPLE_RATE;
+        m_device_config.sampleRate = m_settings.m_sample_rate;
+        m_device_config.periodSizeInFrames = m_settings.m_period_size_in_frames;
+        m_device_config.periods = m_settings.m_periods;
         m_device_config.dataCallback = MiniAudio::data_callback;
         m_device_config.pUserData = this;
 
-        if(ma_device_init(NULL, &m_device_config, &m_device) != MA_SUCCESS)
-            throw std::runtime_error{"PGEX_MiniAudio: failed to initialize device"};
+        /**
+         * without a sound card there's nothing to play on, mix
+         * into the void instead so the game still runs
+         */
+        if(m_settings.m_mode == DeviceMode::Hardware && ma_device_init(NULL, &m_device_config, &m_device) != MA_SUCCESS)
+        {
+            PGEX_MA_LOG("failed to initialize device, falling back to the null device");
+            m_settings.m_mode = DeviceMode::Null;
+        }
+        
+        /**
+         * size the mix buffers for one device period up front, the
+         * data callback is fixed size so this is all it ever needs
+         */
+        ma_uint32 period_frames = m_settings.m_period_size_in_frames;
+        if(m_settings.m_mode == DeviceMode::Hardware)
+        {
+            period_frames = std::max(m_device.playback.intermediaryBufferCap, m_device.playback.internalPeriodSizeInFrames);
+            
+            /**
+             * report what the backend actually gave us, it's free to
+             * round or ignore what was asked for
+             */
+            m_settings.m_sample_rate = m_device.sampleRate;
+            m_settings.m_period_size_in_frames = m_device.playback.internalPeriodSizeInFrames;
+            m_settings.m_periods = m_device.playback.internalPeriods;
+        }
+        else
+        {
+            m_settings.m_periods = 1;   // mixed just in time, nothing queued ahead
+        }
+        if(period_frames == 0)
+        {
+            period_frames = ma_calculate_buffer_size_in_frames_from_milliseconds(MA_DEFAULT_PERIOD_SIZE_IN_MILLISECONDS_LOW_LATENCY, m_settings.m_sample_rate);
+            m_settings.m_period_size_in_frames = period_frames;
+        }
+        
+        m_engine_buffer.assign(period_frames * DEVICE_CHANNELS, 0.0f);
+        m_waveform_buffer.assign(period_frames * DEVICE_CHANNELS, 0.0f);
+        m_noise_buffer.assign(period_frames * DEVICE_CHANNELS, 0.0f);
+        if(m_settings.m_mode != DeviceMode::Hardware)
+            m_render_buffer.assign(period_frames * DEVICE_CHANNELS, 0.0f);
+        PGEX_MA_LOG(std::string("allocated callback buffers of ") + std::to_string(m_engine_buffer.size() * sizeof(float)) + " bytes");
+
+        m_init_timings.m_device_ms = elapsed_ms(stage_start);
+        stage_start = clock::now();
 
         m_resource_manager_config = ma_resource_manager_config_init();
         m_resource_manager_config.decodedFormat     = DEVICE_FORMAT;
         m_resource_manager_config.decodedChannels   = DEVICE_CHANNELS;
-        m_resource_manager_config.decodedSampleRate = DEVICE_SAMPLE_RATE;
+        m_resource_manager_config.decodedSampleRate = m_settings.m_sample_rate;
     
     #ifdef __EMSCRIPTEN__
         m_resource_manager_config.jobThreadCount = 0;                           
         m_resource_manager_config.flags |= MA_RESOURCE_MANAGER_FLAG_NON_BLOCKING;
         m_resource_manager_config.flags |= MA_RESOURCE_MANAGER_FLAG_NO_THREADING;
+    #else
+        /**
+         * an offline mix has to come out the same every run, so stream
+         * pages are decoded by Render itself rather than by job threads
+         * racing it
+         */
+        if(m_settings.m_mode == DeviceMode::Manual)
+        {
+            m_resource_manager_config.jobThreadCount = 0;
+            m_resource_manager_config.flags |= MA_RESOURCE_MANAGER_FLAG_NON_BLOCKING;
+            m_resource_manager_config.flags |= MA_RESOURCE_MANAGER_FLAG_NO_THREADING;
+        }
     #endif
 
         if(ma_resource_manager_init(&m_resource_manager_config, &m_resource_manager) != MA_SUCCESS)
             throw std::runtime_error{"PGEX_MiniAudio: failed to initialize resource manager"};
     
+        m_init_timings.m_resource_manager_ms = elapsed_ms(stage_start);
+        stage_start = clock::now();
+
         m_engine_config = ma_engine_config_init();
-        m_engine_config.pDevice = &m_device;
         m_engine_config.pResourceManager = &m_resource_manager;
+        if(m_settings.m_mode == DeviceMode::Hardware)
+        {
+            m_engine_config.pDevice = &m_device;
+        }
+        else
+        {
+            m_engine_config.noDevice   = MA_TRUE;
+            m_engine_config.channels   = DEVICE_CHANNELS;
+            m_engine_config.sampleRate = m_settings.m_sample_rate;
+        }
     
         if(ma_engine_init(&m_engine_config, &m_engine) != MA_SUCCESS)
             throw std::runtime_error{"PGEX_MiniAudio: failed to initialize engine"};
 
+        m_init_timings.m_engine_ms = elapsed_ms(stage_start);
         m_initialized = true;
+
+        if(m_settings.m_mode == DeviceMode::Null)
+        {
+            m_null_running = true;
+            m_null_thread = std::thread(&MiniAudio::null_device_loop, this);
+        }
     }
 
     MiniAudio::~MiniAudio()
     {
+        /**
+         * the null device mixes on its own thread, stop it before
+         * anything it reads goes away
+         */
+        if(m_null_thread.joinable())
+        {
+            PGEX_MA_LOG("stopping the null device");
+            m_null_running = false;
+            m_null_thread.join();
+        }
+        StopRecording();
+
         PGEX_MA_LOG("unloading all sounds");
 
         /**
@@ -510,9 +978,12 @@ namespace olc
         PGEX_MA_LOG("uninitializing m_resource_manager");
         ma_resource_manager_uninit(&m_resource_manager);
         
-        PGEX_MA_LOG("uninitializing m_device");
-        ma_device_stop(&m_device);
-        ma_device_uninit(&m_device);
+        if(m_settings.m_mode == DeviceMode::Hardware)
+        {
+            PGEX_MA_LOG("uninitializing m_device");
+            ma_device_stop(&m_device);
+            ma_device_uninit(&m_device);
+        }
     }
 
     bool MiniAudio::OnBeforeUserUpdate(float& fElapsedTime)
@@ -521,26 +992,33 @@ namespace olc
         ma_resource_manager_process_next_job(&m_resource_manager);
         #endif
         
+        if(m_reap_on_update)
+            ReapFinishedSounds();
+        
+        return false;
+    }
+
+    void MiniAudio::ReapFinishedSounds()
+    {
         /**
-         * look for the sounds we play once
-         * if they're done playing unload them
+         * unload the sounds we play once which finished since the
+         * last reap, taking the whole completion list in one go
          */
-        for(int i = 0; i < m_sounds.size(); i++)
+        Sound* finished = m_finished_sounds.exchange(nullptr, std::memory_order_acquire);
+        while(finished != nullptr)
         {
-            if(m_sounds.at(i) == nullptr)
-                continue;
-            
-            if(!m_sounds.at(i)->m_play_once)
-                continue;
+            Sound* next = finished->m_next_finished;
             
-            if(ma_sound_is_playing(&m_sounds.at(i)->m_sound))
-                continue;
+            finished->m_finished = false;   // already out of the list
+            UnloadSound(finished->m_id);
             
-            UnloadSound(i);
-            m_count_play_once_sounds--;
+            finished = next;
         }
-        
-        return false;
+    }
+
+    void MiniAudio::SetReapOnUpdate(const bool enabled)
+    {
+        m_reap_on_update = enabled;
     }
 
     void MiniAudio::data_callback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount)
@@ -565,23 +1043,46 @@ namespace olc
         if(!MiniAudio::m_background_playback && !pge->IsFocused())
             return;
 
+        PGEX_MA_TRACE_THREAD("audio device");
+        PGEX_MA_TRACE_SCOPE("audio mix", nullptr);
+
         /**
-         * If required, resize the buffer.
-         * 
-         * Note:    m_engine_buffer is the buffer we mix other buffers
-         *          into prior to copying it to the final output buffer.
+         * The mix buffers are allocated once, at the device's period
+         * size, by the constructor. A bigger request than that is
+         * mixed in chunks, so the audio thread never resizes them.
          */
-        if(m_engine_buffer.size() != (frameCount * DEVICE_CHANNELS))
+        const ma_uint32 buffer_frames = static_cast<ma_uint32>(m_engine_buffer.size() / DEVICE_CHANNELS);
+        float* output = static_cast<float*>(pOutput);
+
+        while(frameCount > 0)
         {
-            m_engine_buffer.resize(frameCount * DEVICE_CHANNELS, 0);
-            m_waveform_buffer.resize(frameCount * DEVICE_CHANNELS, 0);
-            PGEX_MA_LOG(std::string("had to resize callback buffers to ") + std::to_string(m_engine_buffer.size() * sizeof(float)) + " bytes");
+            ma_uint32 frames = std::min(frameCount, buffer_frames);
+            ma->mix_block(output, frames);
+            
+            output += frames * DEVICE_CHANNELS;
+            frameCount -= frames;
         }
+    }
+
+    void MiniAudio::mix_block(float* output, const ma_uint32 frameCount)
+    {
+        /**
+         * Note:    m_engine_buffer is the buffer we mix other buffers
+         *          into prior to copying it to the final output buffer.
+         */
+        const size_t samples = static_cast<size_t>(frameCount) * DEVICE_CHANNELS;
+
+        /**
+         * anything played since the last block starts sounding in
+         * this one
+         */
+        if(m_latency_probe.load(std::memory_order_relaxed))
+            collect_latency_probe();
 
         /**
          * read pcm frames from the engine to the buffer
          */
-        ma_engine_read_pcm_frames(&ma->m_engine, m_engine_buffer.data(), frameCount, NULL);
+        ma_engine_read_pcm_frames(&m_engine, m_engine_buffer.data(), frameCount, NULL);
 
         /**
          * waveforms
@@ -609,39 +1110,255 @@ namespace olc
                 /**
                  * mix waveform buffer into the engine buffer, simple add
                  */
-                for(ma_uint64 i = 0; i < framesRead * DEVICE_CHANNELS; i++)
-                {
-                    m_engine_buffer[i] += m_waveform_buffer[i];
-                }
+                MixAdd(m_engine_buffer.data(), m_waveform_buffer.data(), static_cast<size_t>(framesRead) * DEVICE_CHANNELS);
             }
         }
         
         /**
          * noise generators
          */
-        if(m_noise_callback)
+        if(m_noise_block_callback)
         {
-            for(ma_uint32 i = 0; i < frameCount; i++)
+            auto block_start = std::chrono::steady_clock::now();
+            
+            std::fill_n(m_noise_buffer.begin(), samples, 0.0f);
+            m_noise_block_callback(m_noise_buffer.data(), frameCount, DEVICE_CHANNELS, m_settings.m_sample_rate);
+            MixAdd(m_engine_buffer.data(), m_noise_buffer.data(), samples);
+
+            ma_uint64 ns = static_cast<ma_uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - block_start).count());
+            m_noise_blocks.fetch_add(1, std::memory_order_relaxed);
+            m_noise_total_ns.fetch_add(ns, std::memory_order_relaxed);
+            if(ns > m_noise_max_ns.load(std::memory_order_relaxed))
+                m_noise_max_ns.store(ns, std::memory_order_relaxed);
+        }
+        
+        /**
+         * clamp the output to a range of -1.0f to 1.0f, straight
+         * into the output buffer
+         */
+        Clip(output, m_engine_buffer.data(), samples);
+    }
+
+    void MiniAudio::render_offline(ma_uint64 frameCount, float* output)
+    {
+        const ma_uint32 buffer_frames = static_cast<ma_uint32>(m_render_buffer.size() / DEVICE_CHANNELS);
+        std::lock_guard<std::mutex> lock(m_render_mutex);
+
+        while(frameCount > 0)
+        {
+            ma_uint32 frames = static_cast<ma_uint32>(std::min<ma_uint64>(frameCount, buffer_frames));
+            float* block = (output != nullptr) ? output : m_render_buffer.data();
+            mix_block(block, frames);
+
+            /**
+             * m_engine_buffer still holds the mix from before it was
+             * clipped, which is what clipping regressions show up in
+             */
+            const size_t samples = static_cast<size_t>(frames) * DEVICE_CHANNELS;
+            for(size_t i = 0; i < samples; i++)
             {
-                m_noise_callback(m_noise_left_channel, m_noise_right_channel, 1.0f / DEVICE_SAMPLE_RATE);
+                float level = std::fabs(m_engine_buffer[i]);
+                if(level > 1.0f)
+                    m_render_stats.m_clipped_samples++;
+                if(level > m_render_stats.m_peak)
+                    m_render_stats.m_peak = level;
+            }
+            m_render_stats.m_frames += frames;
+
+            if(m_recording)
+                ma_encoder_write_pcm_frames(&m_encoder, block, frames, NULL);
+
+            if(output != nullptr)
+                output += samples;
+            frameCount -= frames;
+        }
+    }
+
+    void MiniAudio::null_device_loop()
+    {
+        using clock = std::chrono::steady_clock;
+        
+        const ma_uint32 period_frames = static_cast<ma_uint32>(m_render_buffer.size() / DEVICE_CHANNELS);
+        const auto period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(double(period_frames) / m_settings.m_sample_rate));
+        clock::time_point next = clock::now();
 
-                m_engine_buffer[(i * DEVICE_CHANNELS)] += m_noise_left_channel;
-                m_engine_buffer[(i * DEVICE_CHANNELS) + 1] += m_noise_right_channel;
+        PGEX_MA_TRACE_THREAD("audio null device");
+
+        while(m_null_running)
+        {
+            {
+                PGEX_MA_TRACE_SCOPE("audio mix", nullptr);
+                render_offline(period_frames, nullptr);
             }
+            
+            /**
+             * keep to the sample rate on average, but if we've fallen
+             * more than a few periods behind (a debugger, a stalled
+             * host) start afresh rather than mixing a burst to catch up
+             */
+            next += period;
+            clock::time_point now = clock::now();
+            if(now - next > period * 4)
+                next = now;
+            
+            std::this_thread::sleep_until(next);
         }
+    }
+
+    const MiniAudio::DeviceSettings& MiniAudio::GetDeviceSettings() const
+    {
+        return m_settings;
+    }
+
+    void MiniAudio::SetLatencyProbe(const bool enabled)
+    {
+        m_latency_probe = enabled;
+    }
+
+    void MiniAudio::SetPlayRequestTime(const std::chrono::steady_clock::time_point& requested)
+    {
+        m_play_requested = std::chrono::duration_cast<std::chrono::nanoseconds>(requested.time_since_epoch()).count();
+    }
+
+    void MiniAudio::stamp_latency_probe()
+    {
+        if(!m_latency_probe.load(std::memory_order_relaxed))
+            return;
+
+        ma_int64 stamp = m_play_requested;
+        if(stamp == 0)
+            stamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
         
         /**
-         * clamp the output to a range of -1.0f to 1.0f
+         * a slot the audio thread hasn't emptied yet means it's
+         * more than LATENCY_STAMPS plays behind, drop this one
          */
-        for(auto &sample : m_engine_buffer)
+        ma_uint64 slot = m_latency_stamp_head.fetch_add(1, std::memory_order_relaxed) % LATENCY_STAMPS;
+        ma_int64 empty = 0;
+        m_latency_stamps[slot].compare_exchange_strong(empty, stamp, std::memory_order_release, std::memory_order_relaxed);
+    }
+
+    void MiniAudio::collect_latency_probe()
+    {
+        ma_int64 now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        ma_uint64 head = m_latency_stamp_head.load(std::memory_order_acquire);
+        
+        while(m_latency_stamp_tail < head)
         {
-            sample = std::clamp(sample, -1.0f, 1.0f);
+            ma_int64 stamp = m_latency_stamps[m_latency_stamp_tail % LATENCY_STAMPS].exchange(0, std::memory_order_acquire);
+            
+            /**
+             * the slot was claimed but the stamp isn't written yet,
+             * pick it up next block
+             */
+            if(stamp == 0 && head - m_latency_stamp_tail <= LATENCY_STAMPS)
+                break;
+            
+            m_latency_stamp_tail++;
+            if(stamp == 0)
+                continue;
+
+            ma_uint64 index = m_latency_count.load(std::memory_order_relaxed);
+            m_latency_samples[index % LATENCY_SAMPLES].store(static_cast<ma_uint32>(std::max<ma_int64>(0, now - stamp) / 1000), std::memory_order_relaxed);
+            m_latency_count.store(index + 1, std::memory_order_release);
         }
+    }
+
+    MiniAudio::LatencyStats MiniAudio::GetLatencyStats() const
+    {
+        LatencyStats stats;
+        
+        ma_uint32 period_frames = m_settings.m_period_size_in_frames;
+        ma_uint32 periods = std::max<ma_uint32>(m_settings.m_periods, 1);
+        stats.m_buffer_ms = 1000.0 * period_frames * periods / m_settings.m_sample_rate;
+
+        stats.m_samples = m_latency_count.load(std::memory_order_acquire);
+        size_t count = static_cast<size_t>(std::min<ma_uint64>(stats.m_samples, LATENCY_SAMPLES));
+        if(count == 0)
+            return stats;
+
+        std::vector<ma_uint32> sorted(count);
+        for(size_t i = 0; i < count; i++)
+            sorted[i] = m_latency_samples[i].load(std::memory_order_relaxed);
+        std::sort(sorted.begin(), sorted.end());
+
+        auto percentile = [&](double p) { return sorted[std::min(count - 1, static_cast<size_t>(p * count))] / 1000.0; };
+        stats.m_p50_ms = percentile(0.50);
+        stats.m_p90_ms = percentile(0.90);
+        stats.m_p99_ms = percentile(0.99);
+        stats.m_max_ms = sorted.back() / 1000.0;
+        return stats;
+    }
+
+    void MiniAudio::ResetLatencyStats()
+    {
+        m_latency_count = 0;
+    }
+
+    MiniAudio::DeviceMode MiniAudio::GetDeviceMode() const
+    {
+        return m_settings.m_mode;
+    }
+
+    void MiniAudio::Render(const ma_uint64 frameCount, float* output)
+    {
+        if(m_settings.m_mode != DeviceMode::Manual)
+            throw std::runtime_error{"PGEX_MiniAudio: Render is only available in Manual mode"};
 
         /**
-         * Copy the results to the output buffer
+         * finish whatever loading the sounds queued before mixing,
+         * there are no job threads to do it in this mode
          */
-        memcpy(pOutput, m_engine_buffer.data(), m_engine_buffer.size() * sizeof(float));
+        while(ma_resource_manager_process_next_job(&m_resource_manager) == MA_SUCCESS)
+            ;
+
+        render_offline(frameCount, output);
+    }
+
+    bool MiniAudio::StartRecording(const std::string& path)
+    {
+        if(m_settings.m_mode == DeviceMode::Hardware)
+            return false;
+
+        StopRecording();
+        
+        ma_encoder_config config = ma_encoder_config_init(ma_encoding_format_wav, DEVICE_FORMAT, DEVICE_CHANNELS, m_settings.m_sample_rate);
+        
+        std::lock_guard<std::mutex> lock(m_render_mutex);
+        if(ma_encoder_init_file(path.c_str(), &config, &m_encoder) != MA_SUCCESS)
+            return false;
+
+        PGEX_MA_LOG("recording to " + path);
+        m_recording = true;
+        return true;
+    }
+
+    void MiniAudio::StopRecording()
+    {
+        std::lock_guard<std::mutex> lock(m_render_mutex);
+        if(!m_recording)
+            return;
+
+        ma_encoder_uninit(&m_encoder);
+        m_recording = false;
+    }
+
+    bool MiniAudio::IsRecording()
+    {
+        std::lock_guard<std::mutex> lock(m_render_mutex);
+        return m_recording;
+    }
+
+    MiniAudio::RenderStats MiniAudio::GetRenderStats()
+    {
+        std::lock_guard<std::mutex> lock(m_render_mutex);
+        return m_render_stats;
+    }
+
+    void MiniAudio::ResetRenderStats()
+    {
+        std::lock_guard<std::mutex> lock(m_render_mutex);
+        m_render_stats = RenderStats();
     }
 
     void MiniAudio::SetBackgroundPlay(bool state)
@@ -664,7 +1381,18 @@ namespace olc
         
         m_sound_file_buffers.at(path).Load(path, pack);
         
-        if(ma_sound_init_from_file(&m_engine, path.c_str(), MA_SOUND_FLAG_DECODE | MA_SOUND_FLAG_ASYNC, NULL, NULL, &m_sounds.at(id)->m_sound) != MA_SUCCESS)
+        /**
+         * the buffer is registered under its own name, which differs
+         * from the path once the file has been reloaded
+         */
+        const std::string& name = m_sound_file_buffers.at(path).m_path;
+        
+        ma_result result;
+        {
+            PGEX_MA_TRACE_SCOPE("ma_sound_init_from_file", path.c_str());
+            result = ma_sound_init_from_file(&m_engine, name.c_str(), MA_SOUND_FLAG_DECODE | MA_SOUND_FLAG_ASYNC, NULL, NULL, &m_sounds.at(id)->m_sound);
+        }
+        if(result != MA_SUCCESS)
             throw std::runtime_error{"PGEX_MiniAudio: failed to initialize a sound"};
         
         /**
@@ -672,6 +1400,11 @@ namespace olc
          * unloaded when it has finished it's playback.
          */
         m_sounds.at(id)->m_play_once = playOnce;
+        if(playOnce)
+        {
+            ma_sound_set_end_callback(&m_sounds.at(id)->m_sound, on_play_once_end, m_sounds.at(id));
+            m_count_play_once_sounds++;
+        }
 
         /**
          * used to synchronise the underlying sound file buffers
@@ -688,12 +1421,220 @@ namespace olc
         return id;
     }
 
+    const int MiniAudio::LoadSoundFromPcm(const std::string& name, std::vector<float> pcm, const ma_uint32 channels, const ma_uint32 sampleRate)
+    {
+        if(m_sound_file_buffers.find(name) == m_sound_file_buffers.end())
+        {
+            m_sound_file_buffers[name] = SoundFileBuffer(&m_engine);
+        }
+        
+        if(!m_sound_file_buffers.at(name).LoadPcm(name, std::move(pcm), channels, sampleRate))
+            throw std::runtime_error{std::string("PGEX_MiniAudio: failed to register pcm named: ") + name};
+
+        int id = find_or_create_empty_sound_slot();
+        
+        /**
+         * already decoded, so there's nothing for a job thread to do
+         */
+        if(ma_sound_init_from_file(&m_engine, name.c_str(), MA_SOUND_FLAG_DECODE, NULL, NULL, &m_sounds.at(id)->m_sound) != MA_SUCCESS)
+            throw std::runtime_error{"PGEX_MiniAudio: failed to initialize a sound"};
+
+        m_sounds.at(id)->m_path = name;
+
+        ma_sound_get_length_in_pcm_frames(&m_sounds[id]->m_sound, &m_sounds[id]->m_length_in_pcm_frames);
+        ma_sound_get_length_in_seconds(&m_sounds[id]->m_sound, &m_sounds[id]->m_length_in_seconds);
+        
+        PGEX_MA_LOG(m_sounds.at(id)->string());
+        return id;
+    }
+
+    const int MiniAudio::LoadStream(const std::string& path, olc::ResourcePack* pack)
+    {
+        int id = find_or_create_empty_sound_slot();
+
+        ma_uint32 flags = MA_SOUND_FLAG_STREAM;
+        std::string name = path;
+
+        /**
+         * a resource pack can't be streamed from disk, so the encoded
+         * file is kept in memory and decoded on the fly instead of
+         * being decoded up front
+         */
+        if(pack != nullptr)
+        {
+            if(m_sound_file_buffers.find(path) == m_sound_file_buffers.end())
+            {
+                m_sound_file_buffers[path] = SoundFileBuffer(&m_engine);
+            }
+
+            m_sound_file_buffers.at(path).Load(path, pack);
+            name = m_sound_file_buffers.at(path).m_path;
+            flags = MA_SOUND_FLAG_ASYNC;
+        }
+        
+        m_sounds.at(id)->m_file_buffered = (pack != nullptr);
+        
+        ma_result result;
+        {
+            PGEX_MA_TRACE_SCOPE("ma_sound_init_from_file", path.c_str());
+            result = ma_sound_init_from_file(&m_engine, name.c_str(), flags, NULL, NULL, &m_sounds.at(id)->m_sound);
+        }
+        if(result != MA_SUCCESS)
+        {
+            if(pack != nullptr)
+                m_sound_file_buffers.at(path).Unload();
+
+            delete m_sounds.at(id);
+            m_sounds.at(id) = nullptr;
+            m_free_slots.push_back(id);
+            throw std::runtime_error{"PGEX_MiniAudio: failed to initialize a stream"};
+        }
+
+        m_sounds.at(id)->m_streamed = true;
+        m_sounds.at(id)->m_path = path;
+
+        ma_sound_get_length_in_pcm_frames(&m_sounds[id]->m_sound, &m_sounds[id]->m_length_in_pcm_frames);
+        ma_sound_get_length_in_seconds(&m_sounds[id]->m_sound, &m_sounds[id]->m_length_in_seconds);
+        
+        PGEX_MA_LOG(m_sounds.at(id)->string());
+        return id;
+    }
+
+    bool MiniAudio::DecodeFile(const std::string& path, DecodedSound& out, olc::ResourcePack* pack)
+    {
+        PGEX_MA_TRACE_SCOPE("sound decode", path.c_str());
+
+        ma_decoder_config config = ma_decoder_config_init(ma_format_f32, 0, 0);
+        ma_decoder decoder;
+        std::vector<char> encoded;
+        ma_result result;
+        
+        if(pack != nullptr)
+        {
+            if(!pack->Loaded())
+                return false;
+
+            encoded = pack->GetFileBuffer(path).vMemory;
+            result = ma_decoder_init_memory(encoded.data(), encoded.size(), &config, &decoder);
+        }
+        else
+        {
+            result = ma_decoder_init_file(path.c_str(), &config, &decoder);
+        }
+
+        if(result != MA_SUCCESS)
+            return false;
+
+        out.m_channels = decoder.outputChannels;
+        out.m_sample_rate = decoder.outputSampleRate;
+        out.m_pcm.clear();
+
+        ma_uint64 length = 0;
+        if(ma_decoder_get_length_in_pcm_frames(&decoder, &length) == MA_SUCCESS)
+            out.m_pcm.reserve(length * out.m_channels);
+
+        /**
+         * read in chunks, not every format knows its length up front
+         */
+        constexpr ma_uint64 CHUNK_FRAMES = 4096;
+        ma_uint64 read = 0;
+        do
+        {
+            const size_t at = out.m_pcm.size();
+            out.m_pcm.resize(at + CHUNK_FRAMES * out.m_channels);
+            ma_decoder_read_pcm_frames(&decoder, out.m_pcm.data() + at, CHUNK_FRAMES, &read);
+            out.m_pcm.resize(at + read * out.m_channels);
+        } while(read == CHUNK_FRAMES);
+
+        ma_decoder_uninit(&decoder);
+        return !out.m_pcm.empty();
+    }
+
+    void MiniAudio::ReloadSound(const int id, olc::ResourcePack* pack)
+    {
+        Sound* sound = m_sounds.at(id);
+        
+        if(sound == nullptr)
+            throw std::runtime_error{std::string("tried to reload non-existent sound at id(") + std::to_string(id) + ")"};
+
+        /**
+         * a stream straight from disk has nothing decoded up front, it
+         * only needs to open the file again
+         */
+        if(!sound->m_file_buffered)
+        {
+            reinit_sound(sound, sound->m_path, MA_SOUND_FLAG_STREAM);
+            PGEX_MA_LOG(std::string("reloaded ") + sound->string());
+            return;
+        }
+
+        /**
+         * pcm loaded from memory has no file to read again
+         */
+        if(!m_sound_file_buffers.at(sound->m_path).m_from_file)
+            return;
+
+        DecodedSound decoded;
+        if(!DecodeFile(sound->m_path, decoded, pack))
+            throw std::runtime_error{std::string("PGEX_MiniAudio: failed to decode: ") + sound->m_path};
+
+        ReplaceSoundData(id, std::move(decoded));
+    }
+
+    int MiniAudio::ReplaceSoundData(const int id, DecodedSound&& decoded)
+    {
+        Sound* sound = m_sounds.at(id);
+        
+        if(sound == nullptr || !sound->m_file_buffered)
+            throw std::runtime_error{std::string("tried to replace the data of a sound without a file buffer at id(") + std::to_string(id) + ")"};
+
+        const std::string path = sound->m_path;
+        SoundFileBuffer& old = m_sound_file_buffers.at(path);
+
+        /**
+         * the new data is registered under a name of its own, so
+         * anything still reading the old data keeps reading memory
+         * which is still there
+         */
+        SoundFileBuffer fresh(&m_engine);
+        const std::string name = path + "#" + std::to_string(++m_count_reloads);
+        if(!fresh.LoadPcm(name, std::move(decoded.m_pcm), decoded.m_channels, decoded.m_sample_rate))
+            throw std::runtime_error{std::string("PGEX_MiniAudio: failed to register reloaded pcm for: ") + path};
+
+        /**
+         * move every sound sharing the file, voices included, over to
+         * the new data. decoded data needs no decoding job, so each
+         * sound is ready as soon as it's initialised
+         */
+        int swapped = 0;
+        for(Sound* other : m_sounds)
+        {
+            if(other == nullptr || !other->m_file_buffered || other->m_path != path)
+                continue;
+
+            reinit_sound(other, name, other->m_streamed ? MA_SOUND_FLAG_ASYNC : MA_SOUND_FLAG_DECODE);
+            swapped++;
+        }
+
+        /**
+         * nothing plays from the old data any more, so only now is it
+         * safe to unregister and free it
+         */
+        fresh.m_count = old.m_count;
+        fresh.m_from_file = old.m_from_file;
+        old.Release();
+        old = std::move(fresh);
+
+        PGEX_MA_LOG(std::string("replaced the data of ") + std::to_string(swapped) + " sounds loaded from " + path);
+        return swapped;
+    }
+
     void MiniAudio::UnloadSound(const int id)
     {
         if(m_sounds.at(id) == nullptr)
             throw std::runtime_error{std::string("tried to unload non-existent sound at id(") + std::to_string(id) + ")"};
         
-        if(m_sound_file_buffers.find(m_sounds.at(id)->m_path) == m_sound_file_buffers.end())
+        if(m_sounds.at(id)->m_file_buffered && m_sound_file_buffers.find(m_sounds.at(id)->m_path) == m_sound_file_buffers.end())
             throw std::runtime_error{std::string("tried to unload non-existent sound file buffer at path (") + m_sounds.at(id)->m_path + ")"};
         
         /**
@@ -701,6 +1642,11 @@ namespace olc
          */
         if(ma_sound_is_playing(&m_sounds.at(id)->m_sound))
             ma_sound_stop(&m_sounds.at(id)->m_sound);
+
+        /**
+         * voices are copies of the sound, release them first
+         */
+        uninit_voice_pool(m_sounds.at(id));
         
         /**
          * let miniaudio perform it's uninitialization on the sound
@@ -708,9 +1654,22 @@ namespace olc
         ma_sound_uninit(&m_sounds.at(id)->m_sound);
 
         /**
-         * unload the sound file buffer
+         * a play once sound unloaded by hand may already be waiting
+         * in the completion list, it can't be left there dangling
          */
-        m_sound_file_buffers.at(m_sounds.at(id)->m_path).Unload();
+        if(m_sounds.at(id)->m_play_once)
+        {
+            if(m_sounds.at(id)->m_finished)
+                remove_finished(m_sounds.at(id));
+            
+            m_count_play_once_sounds--;
+        }
+
+        /**
+         * unload the sound file buffer, streams read straight from disk don't have one
+         */
+        if(m_sounds.at(id)->m_file_buffered)
+            m_sound_file_buffers.at(m_sounds.at(id)->m_path).Unload();
 
         /**
          * give the memory back to the os
@@ -721,6 +1680,7 @@ namespace olc
          * mark this slot as empy
          */
         m_sounds.at(id) = nullptr;
+        m_free_slots.push_back(id);
     }
 
     void MiniAudio::Play(const int id, const bool looping)
@@ -731,14 +1691,28 @@ namespace olc
         if(looping)
             ma_sound_set_looping(&m_sounds.at(id)->m_sound, true);
         
+        stamp_latency_probe();
         ma_sound_start(&m_sounds.at(id)->m_sound);
     }
     
     const int MiniAudio::Play(const std::string& path, olc::ResourcePack* pack)
     {
+        /**
+         * if this file is already loaded with a voice pool, play it
+         * from there instead of loading and decoding it again
+         */
+        for(int i = 0; i < m_sounds.size(); i++)
+        {
+            if(m_sounds[i] != nullptr && !m_sounds[i]->m_voices.empty() && m_sounds[i]->m_path == path)
+            {
+                PlayVoice(i);
+                return i;
+            }
+        }
+
         int id = LoadSound(path, pack, true);
+        stamp_latency_probe();
         ma_sound_start(&m_sounds.at(id)->m_sound);
-        m_count_play_once_sounds++;
         return id;
     }
 
@@ -749,6 +1723,13 @@ namespace olc
         
         ma_sound_stop(&m_sounds.at(id)->m_sound);
         ma_sound_seek_to_pcm_frame(&m_sounds.at(id)->m_sound, 0);
+
+        /**
+         * stopping a play once sound by hand never reaches its end
+         * callback, so treat it as finished here
+         */
+        if(m_sounds.at(id)->m_play_once)
+            push_finished(m_sounds.at(id));
     }
 
     void MiniAudio::Pause(const int id)
@@ -770,9 +1751,221 @@ namespace olc
         ma_sound_start(&m_sounds.at(id)->m_sound);
     }
 
+    ma_uint64 MiniAudio::GetEngineTimeInPcmFrames()
+    {
+        return ma_engine_get_time_in_pcm_frames(&m_engine);
+    }
+
+    void MiniAudio::PlayWithFadeIn(const int id, const ma_uint64 startTime, const ma_uint64 fadeFrames, const bool looping)
+    {
+        ma_sound* sound = &m_sounds.at(id)->m_sound;
+        const bool playing = ma_sound_is_playing(sound);
+
+        /**
+         * cancel any stop scheduled by an earlier fade out
+         */
+        ma_sound_set_stop_time_in_pcm_frames(sound, ~(ma_uint64)0);
+        ma_sound_set_looping(sound, looping);
+
+        /**
+         * the fade is applied by the audio thread, starting on the
+         * exact frame given, -1 means from the current fade volume
+         */
+        ma_sound_set_fade_start_in_pcm_frames(sound, playing ? -1.0f : 0.0f, 1.0f, fadeFrames, startTime);
+
+        if(playing)
+            return;
+
+        ma_sound_seek_to_pcm_frame(sound, 0);
+        ma_sound_set_start_time_in_pcm_frames(sound, startTime);
+        ma_sound_start(sound);
+    }
+
+    void MiniAudio::StopWithFadeOut(const int id, const ma_uint64 startTime, const ma_uint64 fadeFrames)
+    {
+        ma_sound* sound = &m_sounds.at(id)->m_sound;
+        
+        /**
+         * a sound scheduled to start but not yet audible still needs
+         * stopping, one already stopped, or stopping sooner, doesn't
+         */
+        if(ma_node_get_state(sound) != ma_node_state_started)
+            return;
+
+        if(ma_node_get_state_time(sound, ma_node_state_stopped) <= startTime)
+            return;
+
+        ma_sound_set_stop_time_with_fade_in_pcm_frames(sound, startTime + fadeFrames, fadeFrames);
+    }
+
+    void MiniAudio::CreateVoicePool(const int id, const int voices, const VoiceSteal steal)
+    {
+        Sound* sound = m_sounds.at(id);
+
+        if(sound == nullptr)
+            throw std::runtime_error{std::string("tried to create a voice pool for non-existent sound at id(") + std::to_string(id) + ")"};
+
+        if(sound->m_streamed)
+            throw std::runtime_error{std::string("streamed sounds can't have a voice pool: ") + sound->m_path};
+
+        uninit_voice_pool(sound);
+        sound->m_voice_steal = steal;
+        sound->m_voice_stats = VoiceStats();
+        init_voice_pool(sound, voices);
+    }
+
+    int MiniAudio::PlayVoice(const int id, const float volume, const float pan, const float pitch)
+    {
+        Sound* sound = m_sounds.at(id);
+
+        if(sound == nullptr || sound->m_voices.empty())
+            throw std::runtime_error{std::string("tried to play a voice of sound without a voice pool at id(") + std::to_string(id) + ")"};
+
+        auto& voices = sound->m_voices;
+        const size_t count = voices.size();
+        
+        /**
+         * round robin: take the first free voice after the one used
+         * last, counting the busy ones on the way for the stats
+         */
+        size_t chosen = count;
+        int active = 0;
+        for(size_t n = 0; n < count; n++)
+        {
+            size_t i = (sound->m_next_voice + n) % count;
+            if(ma_sound_is_playing(&voices[i]->m_sound))
+                active++;
+            else if(chosen == count)
+                chosen = i;
+        }
+
+        /**
+         * every voice is busy, steal one
+         */
+        if(chosen == count)
+        {
+            chosen = 0;
+            for(size_t i = 1; i < count; i++)
+            {
+                const Voice& candidate = *voices[i];
+                const Voice& best = *voices[chosen];
+                
+                bool better = candidate.m_started < best.m_started;
+                if(sound->m_voice_steal == VoiceSteal::Quietest && candidate.m_volume != best.m_volume)
+                    better = candidate.m_volume < best.m_volume;
+
+                if(better)
+                    chosen = i;
+            }
+
+            ma_sound_stop(&voices[chosen]->m_sound);
+            sound->m_voice_stats.m_steals++;
+            active--;
+        }
+
+        Voice& voice = *voices[chosen];
+        voice.m_volume = std::clamp(volume, 0.0f, 1.0f);
+        voice.m_started = ++sound->m_voice_stats.m_plays;
+        voice.m_emitter = -1;
+
+        ma_sound_set_volume(&voice.m_sound, voice.m_volume);
+        ma_sound_set_pan(&voice.m_sound, std::clamp(pan, -1.0f, 1.0f));
+        ma_sound_set_pitch(&voice.m_sound, std::max(0.0f, pitch));
+        ma_sound_seek_to_pcm_frame(&voice.m_sound, 0);
+        stamp_latency_probe();
+        ma_sound_start(&voice.m_sound);
+
+        sound->m_next_voice = (chosen + 1) % count;
+        sound->m_voice_stats.m_peak_active = std::max(sound->m_voice_stats.m_peak_active, active + 1);
+        
+        return static_cast<int>(chosen);
+    }
+
+    int MiniAudio::PlayVoiceAt(const int id, const int emitter, const float volume, const float pitch)
+    {
+        Emitter placed;
+        if(emitter >= 0 && emitter < static_cast<int>(m_emitters.size()))
+            placed = m_emitters[emitter];
+
+        const int chosen = PlayVoice(id, volume * placed.m_gain, placed.m_pan, pitch);
+        
+        /**
+         * remember the volume before the gain, so UpdateEmitters
+         * scales from it rather than compounding
+         */
+        Voice& voice = *m_sounds.at(id)->m_voices[chosen];
+        voice.m_volume = std::clamp(volume, 0.0f, 1.0f);
+        voice.m_emitter = emitter;
+
+        return chosen;
+    }
+
+    void MiniAudio::SetEmitter(const int emitter, const float pan, const float gain)
+    {
+        if(emitter < 0)
+            return;
+
+        if(emitter >= static_cast<int>(m_emitters.size()))
+            m_emitters.resize(emitter + 1);
+
+        m_emitters[emitter].m_pan = std::clamp(pan, -1.0f, 1.0f);
+        m_emitters[emitter].m_gain = std::clamp(gain, 0.0f, 1.0f);
+    }
+
+    void MiniAudio::UpdateEmitters()
+    {
+        for(Sound* sound : m_sounds)
+        {
+            if(sound == nullptr)
+                continue;
+
+            for(auto& voice : sound->m_voices)
+            {
+                if(voice->m_emitter < 0 || voice->m_emitter >= static_cast<int>(m_emitters.size()))
+                    continue;
+
+                /**
+                 * a finished voice stops following, so a point emitter
+                 * handed to a new source later doesn't move it
+                 */
+                if(!ma_sound_is_playing(&voice->m_sound))
+                {
+                    voice->m_emitter = -1;
+                    continue;
+                }
+
+                const Emitter& emitter = m_emitters[voice->m_emitter];
+                ma_sound_set_pan(&voice->m_sound, emitter.m_pan);
+                ma_sound_set_volume(&voice->m_sound, voice->m_volume * emitter.m_gain);
+            }
+        }
+    }
+
+    void MiniAudio::StopVoices(const int id)
+    {
+        for(auto& voice : m_sounds.at(id)->m_voices)
+            ma_sound_stop(&voice->m_sound);
+    }
+
+    MiniAudio::VoiceStats MiniAudio::GetVoiceStats(const int id)
+    {
+        Sound* sound = m_sounds.at(id);
+        VoiceStats stats = sound->m_voice_stats;
+        
+        stats.m_voices = static_cast<int>(sound->m_voices.size());
+        stats.m_active = 0;
+        for(auto& voice : sound->m_voices)
+        {
+            if(ma_sound_is_playing(&voice->m_sound))
+                stats.m_active++;
+        }
+
+        return stats;
+    }
+
     void MiniAudio::Seek(const int id, const ma_uint64 milliseconds)
     {
-        ma_uint64 frame_to_seek_to = (milliseconds * DEVICE_SAMPLE_RATE) / 1000;
+        ma_uint64 frame_to_seek_to = (milliseconds * m_settings.m_sample_rate) / 1000;
         ma_sound_seek_to_pcm_frame(&m_sounds.at(id)->m_sound, frame_to_seek_to);
     }
 
@@ -790,7 +1983,7 @@ namespace olc
         ma_sound_get_cursor_in_pcm_frames(&m_sounds.at(id)->m_sound, &frame_to_seek_to);
         
         // calculate the step and add it to the current position
-        frame_to_seek_to += ((milliseconds * DEVICE_SAMPLE_RATE) / 1000);
+        frame_to_seek_to += ((milliseconds * m_settings.m_sample_rate) / 1000);
 
         // seek to the new position
         ma_sound_seek_to_pcm_frame(&m_sounds.at(id)->m_sound, frame_to_seek_to);
@@ -804,7 +1997,7 @@ namespace olc
         ma_sound_get_cursor_in_pcm_frames(&m_sounds.at(id)->m_sound, &frame_to_seek_to);
         
         // calculate the step and subtract it to the current position
-        frame_to_seek_to -= ((milliseconds * DEVICE_SAMPLE_RATE) / 1000);
+        frame_to_seek_to -= ((milliseconds * m_settings.m_sample_rate) / 1000);
 
         // seek to the new position
         ma_sound_seek_to_pcm_frame(&m_sounds.at(id)->m_sound, frame_to_seek_to);
@@ -837,7 +2030,7 @@ namespace olc
     {
         ma_uint64 cursor;
         ma_sound_get_cursor_in_pcm_frames(&m_sounds.at(id)->m_sound, &cursor);
-        return (cursor * 1000) / DEVICE_SAMPLE_RATE;
+        return (cursor * 1000) / m_settings.m_sample_rate;
     }
     
     float MiniAudio::GetCursorFloat(const int id)
@@ -852,6 +2045,25 @@ namespace olc
         return m_count_play_once_sounds;
     }
 
+    ma_uint64 MiniAudio::GetResidentBytes(const int id)
+    {
+        const ma_uint64 bytes_per_frame = DEVICE_CHANNELS * sizeof(float);
+        
+        /**
+         * a stream only ever holds two pages of decoded audio
+         */
+        if(m_sounds.at(id)->m_streamed && !m_sounds.at(id)->m_file_buffered)
+            return 2 * (MA_RESOURCE_MANAGER_PAGE_SIZE_IN_MILLISECONDS * m_settings.m_sample_rate / 1000) * bytes_per_frame;
+        
+        if(m_sounds.at(id)->m_streamed)
+        {
+            const SoundFileBuffer& buffer = m_sound_file_buffers.at(m_sounds.at(id)->m_path);
+            return buffer.m_buffer.size() + buffer.m_pcm.size() * sizeof(float);
+        }
+
+        return m_sounds.at(id)->m_length_in_pcm_frames * bytes_per_frame;
+    }
+
     const int MiniAudio::CreateWaveform(const double amplitude, const double frequency, const ma_waveform_type waveformType)
     {
         // attempt to re-use an empty slot
@@ -866,7 +2078,7 @@ namespace olc
 
         // no empty slots, make more room!
         const int id = static_cast<int>(m_waveforms.size());
-        m_waveforms.emplace_back(amplitude, frequency, waveformType);
+        m_waveforms.emplace_back(amplitude, frequency, waveformType, m_settings.m_sample_rate);
         return id;
     }
 
@@ -929,18 +2141,145 @@ namespace olc
     void MiniAudio::SetNoiseCallback(std::function<void(float& noiseLeftChannel, float& noiseRightChannel, const float fElapsedTime)>callbackFunc)
     {
         m_noise_callback = callbackFunc;
+
+        /**
+         * the per sample callback runs inside a block callback, the
+         * lambda captures nothing so it fits in std::function's
+         * small buffer and doesn't allocate
+         */
+        SetNoiseBlockCallback([](float* buffer, const ma_uint32 frameCount, const ma_uint32 channels, const ma_uint32 sampleRate)
+        {
+            const float sample_time = 1.0f / sampleRate;
+            for(ma_uint32 i = 0; i < frameCount; i++)
+            {
+                m_noise_callback(m_noise_left_channel, m_noise_right_channel, sample_time);
+
+                buffer[(i * channels)] = m_noise_left_channel;
+                buffer[(i * channels) + 1] = m_noise_right_channel;
+            }
+        });
+    }
+
+    void MiniAudio::SetNoiseBlockCallback(NoiseBlockCallback callbackFunc)
+    {
+        m_noise_block_callback = callbackFunc;
+        ResetNoiseCallbackTiming();
     }
 
     void MiniAudio::ClearNoiseCallback()
     {
         MiniAudio::m_noise_left_channel = 0.0f;
         MiniAudio::m_noise_right_channel = 0.0f;
+        m_noise_block_callback = {};
         m_noise_callback = {};
     }
 
+    MiniAudio::CallbackTiming MiniAudio::GetNoiseCallbackTiming() const
+    {
+        CallbackTiming timing;
+        timing.m_blocks = m_noise_blocks.load(std::memory_order_relaxed);
+        if(timing.m_blocks > 0)
+            timing.m_average_us = m_noise_total_ns.load(std::memory_order_relaxed) / 1000.0 / timing.m_blocks;
+        timing.m_max_us = m_noise_max_ns.load(std::memory_order_relaxed) / 1000.0;
+        return timing;
+    }
+
+    void MiniAudio::ResetNoiseCallbackTiming()
+    {
+        m_noise_blocks = 0;
+        m_noise_total_ns = 0;
+        m_noise_max_ns = 0;
+    }
+
+    /**
+     * each kernel takes the widest vectors the build allows, then
+     * narrower ones, then finishes the tail one sample at a time
+     */
+    void MiniAudio::MixAdd(float* dst, const float* src, const size_t count)
+    {
+        size_t i = 0;
+    #if defined(PGEX_MA_AVX)
+        for(; i + 8 <= count; i += 8)
+            _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_loadu_ps(src + i)));
+    #endif
+    #if defined(PGEX_MA_SSE2)
+        for(; i + 4 <= count; i += 4)
+            _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+    #elif defined(PGEX_MA_NEON)
+        for(; i + 4 <= count; i += 4)
+            vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vld1q_f32(src + i)));
+    #endif
+        for(; i < count; i++)
+            dst[i] += src[i];
+    }
+
+    void MiniAudio::MixAddScaled(float* dst, const float* src, const float gain, const size_t count)
+    {
+        size_t i = 0;
+    #if defined(PGEX_MA_AVX)
+        const __m256 g8 = _mm256_set1_ps(gain);
+        for(; i + 8 <= count; i += 8)
+            _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), g8)));
+    #endif
+    #if defined(PGEX_MA_SSE2)
+        const __m128 g = _mm_set1_ps(gain);
+        for(; i + 4 <= count; i += 4)
+            _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+    #elif defined(PGEX_MA_NEON)
+        for(; i + 4 <= count; i += 4)
+            vst1q_f32(dst + i, vmlaq_n_f32(vld1q_f32(dst + i), vld1q_f32(src + i), gain));
+    #endif
+        for(; i < count; i++)
+            dst[i] += src[i] * gain;
+    }
+
+    void MiniAudio::ApplyGain(float* buffer, const float gain, const size_t count)
+    {
+        size_t i = 0;
+    #if defined(PGEX_MA_AVX)
+        const __m256 g8 = _mm256_set1_ps(gain);
+        for(; i + 8 <= count; i += 8)
+            _mm256_storeu_ps(buffer + i, _mm256_mul_ps(_mm256_loadu_ps(buffer + i), g8));
+    #endif
+    #if defined(PGEX_MA_SSE2)
+        const __m128 g = _mm_set1_ps(gain);
+        for(; i + 4 <= count; i += 4)
+            _mm_storeu_ps(buffer + i, _mm_mul_ps(_mm_loadu_ps(buffer + i), g));
+    #elif defined(PGEX_MA_NEON)
+        for(; i + 4 <= count; i += 4)
+            vst1q_f32(buffer + i, vmulq_n_f32(vld1q_f32(buffer + i), gain));
+    #endif
+        for(; i < count; i++)
+            buffer[i] *= gain;
+    }
+
+    void MiniAudio::Clip(float* dst, const float* src, const size_t count)
+    {
+        size_t i = 0;
+    #if defined(PGEX_MA_AVX)
+        const __m256 lo8 = _mm256_set1_ps(-1.0f);
+        const __m256 hi8 = _mm256_set1_ps(1.0f);
+        for(; i + 8 <= count; i += 8)
+            _mm256_storeu_ps(dst + i, _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(src + i), lo8), hi8));
+    #endif
+    #if defined(PGEX_MA_SSE2)
+        const __m128 lo = _mm_set1_ps(-1.0f);
+        const __m128 hi = _mm_set1_ps(1.0f);
+        for(; i + 4 <= count; i += 4)
+            _mm_storeu_ps(dst + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i), lo), hi));
+    #elif defined(PGEX_MA_NEON)
+        const float32x4_t lo = vdupq_n_f32(-1.0f);
+        const float32x4_t hi = vdupq_n_f32(1.0f);
+        for(; i + 4 <= count; i += 4)
+            vst1q_f32(dst + i, vminq_f32(vmaxq_f32(vld1q_f32(src + i), lo), hi));
+    #endif
+        for(; i < count; i++)
+            dst[i] = std::clamp(src[i], -1.0f, 1.0f);
+    }
+
     ma_device* MiniAudio::GetDevice()
     {
-        return &m_device;
+        return (m_settings.m_mode == DeviceMode::Hardware) ? &m_device : nullptr;
     }
 
     ma_engine* MiniAudio::GetEngine()
@@ -964,27 +2303,157 @@ namespace olc
         return &m_sounds.at(id)->m_sound;
     }
 
+    const MiniAudio::InitTimings& MiniAudio::GetInitTimings() const
+    {
+        return m_init_timings;
+    }
+
     const int MiniAudio::find_or_create_empty_sound_slot()
     {
+        int i;
+        
         /**
-         * look for empty slots for re-use
+         * re-use the most recently emptied slot
          */
-        for(int i = 0; i < m_sounds.size(); i++)
+        if(!m_free_slots.empty())
         {
-            if(m_sounds[i] == nullptr)
+            i = m_free_slots.back();
+            m_free_slots.pop_back();
+            m_sounds.at(i) = new Sound();
+        }
+        else
+        {
+            /**
+             * create a new slot
+             */
+            i = static_cast<int>(m_sounds.size());
+            m_sounds.push_back(new Sound());
+        }
+
+        m_sounds.at(i)->m_id = i;
+        m_sounds.at(i)->m_owner = this;
+        return i;
+    }
+
+    void MiniAudio::on_play_once_end(void* pUserData, ma_sound*)
+    {
+        Sound* sound = static_cast<Sound*>(pUserData);
+        sound->m_owner->push_finished(sound);
+    }
+
+    void MiniAudio::push_finished(Sound* sound)
+    {
+        /**
+         * the end callback and a manual Stop can race, only the first
+         * one to get here links the sound in
+         */
+        if(sound->m_finished.exchange(true))
+            return;
+
+        Sound* head = m_finished_sounds.load(std::memory_order_relaxed);
+        do
+        {
+            sound->m_next_finished = head;
+        } while(!m_finished_sounds.compare_exchange_weak(head, sound, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    void MiniAudio::remove_finished(Sound* sound)
+    {
+        /**
+         * only the thread that reaps takes from the list, and it is the
+         * one unloading, so it can take everything and push back all but
+         * this one
+         */
+        Sound* finished = m_finished_sounds.exchange(nullptr, std::memory_order_acquire);
+        while(finished != nullptr)
+        {
+            Sound* next = finished->m_next_finished;
+            
+            if(finished != sound)
             {
-                m_sounds.at(i) = new Sound();
-                return i;
+                finished->m_finished = false;
+                push_finished(finished);
             }
-                
+            
+            finished = next;
         }
+    }
 
+    void MiniAudio::init_voice_pool(Sound* sound, const int voices)
+    {
+        for(int i = 0; i < voices; i++)
+        {
+            auto voice = std::make_unique<Voice>();
+            
+            /**
+             * copies share the resource manager's decoded data instead of decoding their own
+             */
+            if(ma_sound_init_copy(&m_engine, &sound->m_sound, 0, NULL, &voice->m_sound) != MA_SUCCESS)
+            {
+                uninit_voice_pool(sound);
+                throw std::runtime_error{std::string("PGEX_MiniAudio: failed to initialize a voice for: ") + sound->m_path};
+            }
+            
+            sound->m_voices.push_back(std::move(voice));
+        }
+        
+        sound->m_next_voice = 0;
+        PGEX_MA_LOG(std::to_string(voices) + " voices for " + sound->m_path);
+    }
+
+    void MiniAudio::reinit_sound(Sound* sound, const std::string& name, const ma_uint32 flags)
+    {
         /**
-         * create a new slot
+         * remember how the sound was set up so the swap is seamless
          */
-        int i = static_cast<int>(m_sounds.size());
-        m_sounds.push_back(new Sound());
-        return i;
+        const bool was_playing = ma_sound_is_playing(&sound->m_sound);
+        const bool looping = ma_sound_is_looping(&sound->m_sound);
+        const float volume = ma_sound_get_volume(&sound->m_sound);
+        const float pan = ma_sound_get_pan(&sound->m_sound);
+        const float pitch = ma_sound_get_pitch(&sound->m_sound);
+
+        /**
+         * the pool's voices share the old data, rebuild them afterwards
+         */
+        const int voices = static_cast<int>(sound->m_voices.size());
+        uninit_voice_pool(sound);
+
+        ma_sound_stop(&sound->m_sound);
+        ma_sound_uninit(&sound->m_sound);
+
+        ma_result result;
+        {
+            PGEX_MA_TRACE_SCOPE("ma_sound_init_from_file", sound->m_path.c_str());
+            result = ma_sound_init_from_file(&m_engine, name.c_str(), flags, NULL, NULL, &sound->m_sound);
+        }
+        if(result != MA_SUCCESS)
+            throw std::runtime_error{"PGEX_MiniAudio: failed to reinitialize a sound"};
+
+        ma_sound_get_length_in_pcm_frames(&sound->m_sound, &sound->m_length_in_pcm_frames);
+        ma_sound_get_length_in_seconds(&sound->m_sound, &sound->m_length_in_seconds);
+
+        if(sound->m_play_once)
+            ma_sound_set_end_callback(&sound->m_sound, on_play_once_end, sound);
+
+        ma_sound_set_looping(&sound->m_sound, looping);
+        ma_sound_set_volume(&sound->m_sound, volume);
+        ma_sound_set_pan(&sound->m_sound, pan);
+        ma_sound_set_pitch(&sound->m_sound, pitch);
+
+        if(was_playing)
+            ma_sound_start(&sound->m_sound);
+
+        if(voices > 0)
+            init_voice_pool(sound, voices);
+    }
+
+    void MiniAudio::uninit_voice_pool(Sound* sound)
+    {
+        for(auto& voice : sound->m_voices)
+            ma_sound_uninit(&voice->m_sound);
+
+        sound->m_voices.clear();
+        sound->m_next_voice = 0;
     }
 
 #pragma endregion
@@ -1377,6 +1377,10 @@ namespace olc
 		uint32_t GetFPS() const;
 		// Gets last update of elapsed time
 		float GetElapsedTime() const;
+		// Time the engine's own frame work took last frame, in seconds: input scan,
+		// layer upload and decal submission, and presenting the frame
+		struct CoreTimings { float fInput = 0.0f; float fLayerUpload = 0.0f; float fPresent = 0.0f; };
+		const CoreTimings& GetCoreTimings() const;
 		// Gets Actual Window size
 		const olc::vi2d& GetWindowSize() const;
 		// Gets Actual Window position
@@ -1617,6 +1621,7 @@ namespace olc
 		olc::vi2d	vResizeRequested = { 0, 0 };
 		float		fFrameTimer = 1.0f;
 		float		fLastElapsed = 0.0f;
+		CoreTimings	coreTimings;
 		int			nFrameCount = 0;
 		bool bSuspendTextureTransfer = false;
 		Renderable  fontRenderable;
@@ -2129,6 +2134,8 @@ namespace olc
 	olc::rcode Sprite::LoadFromFile(const std::string& sImageFile, olc::ResourcePack* pack)
 	{
 		UNUSED(pack);
+		// Headless builds get no loader unless one is chosen explicitly
+		if (!loader) return olc::rcode::FAIL;
 		return loader->LoadImageResource(this, sImageFile, pack);
 	}
 
@@ -2694,6 +2701,11 @@ namespace olc
 		return fLastElapsed;
 	}
 
+	const PixelGameEngine::CoreTimings& PixelGameEngine::GetCoreTimings() const
+	{
+		return coreTimings;
+	}
+
 	const olc::vi2d& PixelGameEngine::GetWindowSize() const
 	{
 		return vWindowSize;
@@ -4794,6 +4806,15 @@ namespace olc
 		if (bConsoleSuspendTime)
 			fElapsedTime = 0.0f;
 
+		auto tpCore = std::chrono::steady_clock::now();
+		auto CoreSeconds = [&tpCore]()
+			{
+				auto tp = std::chrono::steady_clock::now();
+				float seconds = std::chrono::duration<float>(tp - tpCore).count();
+				tpCore = tp;
+				return seconds;
+			};
+
 		// Some platforms will need to check for events
 		platform->HandleSystemEvent();
 
@@ -4842,6 +4863,7 @@ namespace olc
 		{
 			UpdateTextEntry();
 		}
+		coreTimings.fInput = CoreSeconds();
 
 		// Handle Frame Update
 		bool bExtensionBlockFrame = false;
@@ -4863,6 +4885,7 @@ namespace olc
 			vViewPos = { 0,0 };
 		}
 
+		CoreSeconds();
 		if (!bManualRenderEnable)
 		{
 			if (bConsoleShow)
@@ -4915,8 +4938,11 @@ namespace olc
 			}
 		}
 
+		coreTimings.fLayerUpload = CoreSeconds();
+
 		// Present Graphics to screen
 		renderer->DisplayFrame();
+		coreTimings.fPresent = CoreSeconds();
 
 		if (bResizeRequested)
 		{
@@ -6414,10 +6440,13 @@ namespace olc
 // | END RENDERER: OpenGL 3.3 (3.0 es) (sh-sh-sh-shaders....)                     |
 // O------------------------------------------------------------------------------O
 #pragma endregion
+#endif // Headless
 
 // O------------------------------------------------------------------------------O
 // | olcPixelGameEngine Image loaders                                             |
 // O------------------------------------------------------------------------------O
+// Headless builds have none by default, but a loader chosen explicitly with
+// OLC_IMAGE_GDI or OLC_IMAGE_LIBPNG is built, so tools can still read sprites
 
 #pragma region image_gdi
 // O------------------------------------------------------------------------------O
@@ -6425,6 +6454,13 @@ namespace olc
 // O------------------------------------------------------------------------------O
 #if defined(OLC_IMAGE_GDI)
 
+#if defined(OLC_PGE_HEADLESS)
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
 #define min(a, b) ((a < b) ? a : b)
 #define max(a, b) ((a > b) ? a : b)
 #include <objidl.h>
@@ -6664,6 +6700,7 @@ namespace olc
 // O------------------------------------------------------------------------------O
 #pragma endregion
 
+#if !defined(OLC_PGE_HEADLESS)
 
 // O------------------------------------------------------------------------------O
 // | olcPixelGameEngine Platforms                                                 |
@@ -70,6 +70,79 @@ namespace GameConfig {
     constexpr float DIFFICULTY_NORMAL_MULT = 1.0f;
     constexpr float DIFFICULTY_HARD_MULT = 1.4f;
     
+    // Startup Profiling
+    constexpr const char* STARTUP_REPORT_FILE = "startup_report.json";
+    constexpr float STARTUP_BUDGET_MS = 0.0f;           // 0 = no budget, override with STARFALL_STARTUP_BUDGET_MS
+
+    // Hot Reload (debug builds watch assets/ and swap changed files in while running)
+#ifdef _DEBUG
+    constexpr bool HOT_RELOAD_ASSETS = true;
+#else
+    constexpr bool HOT_RELOAD_ASSETS = false;
+#endif
+    constexpr const char* HOT_RELOAD_DIR = "assets";
+
+    // Sound Effects
+    constexpr int SFX_VOICES = 4;                       // Overlapping plays per effect before the oldest is cut off
+    constexpr float SFX_EXPLOSION_SMALL_INTERVAL = 0.06f;   // Minimum seconds between retriggers
+    constexpr float SFX_EXPLOSION_LARGE_INTERVAL = 0.10f;
+    constexpr float SFX_BOSS_HIT_INTERVAL = 0.08f;
+    constexpr float SFX_PAN_WIDTH = 0.8f;               // Pan at the screen edges, short of hard left/right
+    constexpr float SFX_FULL_VOLUME_DISTANCE = 120.0f;  // Positional sounds this close to the player play at full volume
+    constexpr float SFX_FALLOFF_DISTANCE = 600.0f;      // ...then fade over this many pixels
+    constexpr float SFX_MIN_DISTANCE_GAIN = 0.35f;      // ...down to this gain
+    constexpr int SFX_POINT_EMITTERS = 32;              // Fixed spots positional sounds follow, handed out in turn
+    constexpr float SFX_EMITTER_SECONDS = 1.0f;         // How long a spot keeps being updated, longer than any effect
+    constexpr bool PROCEDURAL_SFX = true;               // Synthesise shoot/powerup/menu/boss hit instead of decoding WAVs
+    constexpr const char* SFX_CACHE_DIR = "cache/sfx";
+    constexpr int SFX_SHOOT_VARIATIONS = 3;             // Extra pitch-jittered shots, so rapid fire doesn't drone
+    constexpr float SFX_SHOOT_PITCH_JITTER = 0.06f;
+
+    // Audio Device (STARFALL_AUDIO_RATE / _PERIOD / _PERIODS override these at launch)
+    constexpr unsigned AUDIO_SAMPLE_RATE = 48000;
+    constexpr unsigned AUDIO_PERIOD_FRAMES = 0;         // 0 = miniaudio's low latency default (10 ms)
+    constexpr unsigned AUDIO_PERIODS = 0;               // 0 = the backend's default
+    constexpr unsigned AUDIO_MIN_SAMPLE_RATE = 8000;    // Overrides outside these limits are ignored
+    constexpr unsigned AUDIO_MAX_SAMPLE_RATE = 384000;
+    constexpr unsigned AUDIO_MAX_PERIOD_FRAMES = 16384; // ~340 ms at 48 kHz
+    constexpr unsigned AUDIO_MAX_PERIODS = 16;
+#ifdef _DEBUG
+    constexpr bool AUDIO_LATENCY_PROBE = true;          // Measure play-to-mix latency, reported on exit
+#else
+    constexpr bool AUDIO_LATENCY_PROBE = false;
+#endif
+
+    // Music
+    constexpr float MUSIC_VOLUME = 0.6f;
+    constexpr float MUSIC_FADE_SECONDS = 1.0f;          // Length of every fade in, fade out and crossfade
+
+    // Replays (STARFALL_RECORD=<file> records each game, STARFALL_REPLAY=<file> plays one back)
+    constexpr float REPLAY_DT = 1.0f / 120.0f;          // Fixed gameplay tick while recording
+    constexpr int REPLAY_MAX_TICKS_PER_FRAME = 8;       // A long stall drops time rather than spiralling
+
+    // World Snapshots
+    constexpr size_t SNAPSHOT_BUDGET_BYTES = 64 * 1024; // The simulator flags a final world bigger than this
+
+    // Frame Profiler (F3 toggles the overlay, STARFALL_PROFILE_CSV=<file> sets where the CSV goes)
+    constexpr size_t FRAME_PROFILE_FRAMES = 600;        // Frames kept, 10 s at 60 Hz
+#ifdef _DEBUG
+    constexpr const char* FRAME_PROFILE_CSV = "frame_profile.csv";  // Written on exit
+#else
+    constexpr const char* FRAME_PROFILE_CSV = "";
+#endif
+
+    // Tracing (STARFALL_TRACE=<file.json> records a Chrome/Perfetto timeline of every thread)
+    constexpr size_t TRACE_EVENTS_PER_THREAD = 1 << 16; // 4 MB per thread, a few minutes of frames
+
+    // Allocation Tracking (build with STARFALL_ALLOC_TRACKING; F4 shows allocations per tag)
+    constexpr uint64_t ALLOC_BUDGET_PER_FRAME = 512;    // A whole gameplay frame on the engine thread: ~8 per DrawDecal, ~50 decals busy
+    constexpr uint64_t ALLOC_BUDGET_PER_TICK = 0;       // One simulator tick: update, collisions and sound requests
+    constexpr float ALLOC_WARMUP_SECONDS = 2.0f;        // Into a level before its frames count against the budget
+
+    // Golden Frames (simulator --frames/--golden)
+    constexpr int GOLDEN_CHANNEL_TOLERANCE = 8;         // Per channel, out of 255, before a pixel counts as different
+    constexpr float GOLDEN_MAX_DIFF_FRACTION = 0.001f;  // Of a frame's pixels that may differ before it fails
+
     // Asteroid Settings
     constexpr float ASTEROID_RADIUS_MIN = 24.0f;
     constexpr float ASTEROID_RADIUS_MAX = 40.0f;
@@ -0,0 +1,245 @@
+#include "alloc_tracker.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <sstream>
+
+namespace {
+    // Everything here is touched from inside operator new, so none of it may allocate
+    struct TagSlot {
+        std::atomic<const char*> tag{ nullptr };
+        std::atomic<uint64_t> allocations{ 0 };
+        std::atomic<uint64_t> bytes{ 0 };
+        std::atomic<uint64_t> frees{ 0 };
+    };
+
+    TagSlot tagSlots[AllocTracker::MAX_TAGS];
+    std::atomic<size_t> tagCount{ 0 };
+    std::mutex tagMutex;                    // Only taken to add a tag
+
+    std::atomic<uint64_t> totalAllocations{ 0 };
+    std::atomic<uint64_t> totalBytes{ 0 };
+    std::atomic<uint64_t> totalFrees{ 0 };
+
+    thread_local AllocTracker::Counts threadCounts;
+    thread_local int currentTag = -1;
+
+    int tagIndex(const char* tag) {
+        size_t count = tagCount.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; i++) {
+            const char* known = tagSlots[i].tag.load(std::memory_order_relaxed);
+            if (known == tag || std::strcmp(known, tag) == 0) return int(i);
+        }
+
+        std::lock_guard<std::mutex> lock(tagMutex);
+        count = tagCount.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < count; i++) {
+            if (std::strcmp(tagSlots[i].tag.load(std::memory_order_relaxed), tag) == 0) return int(i);
+        }
+        // Out of slots: charge it to no tag rather than mixing it into another
+        if (count == AllocTracker::MAX_TAGS) return -1;
+
+        tagSlots[count].tag.store(tag, std::memory_order_relaxed);
+        tagCount.store(count + 1, std::memory_order_release);
+        return int(count);
+    }
+
+#ifdef STARFALL_ALLOC_TRACKING
+    void noteAlloc(size_t size) {
+        threadCounts.allocations++;
+        threadCounts.bytes += size;
+        totalAllocations.fetch_add(1, std::memory_order_relaxed);
+        totalBytes.fetch_add(size, std::memory_order_relaxed);
+        if (currentTag >= 0) {
+            tagSlots[currentTag].allocations.fetch_add(1, std::memory_order_relaxed);
+            tagSlots[currentTag].bytes.fetch_add(size, std::memory_order_relaxed);
+        }
+    }
+
+    void noteFree() {
+        threadCounts.frees++;
+        totalFrees.fetch_add(1, std::memory_order_relaxed);
+        if (currentTag >= 0) tagSlots[currentTag].frees.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void* trackedAlloc(size_t size) {
+        noteAlloc(size);
+        return std::malloc(size ? size : 1);
+    }
+
+    void* trackedAlignedAlloc(size_t size, std::align_val_t alignment) {
+        noteAlloc(size);
+        size_t align = std::max(size_t(alignment), sizeof(void*));
+#ifdef _MSC_VER
+        return _aligned_malloc(size ? size : 1, align);
+#else
+        // aligned_alloc wants the size to be a multiple of the alignment
+        return std::aligned_alloc(align, (std::max<size_t>(size, 1) + align - 1) / align * align);
+#endif
+    }
+
+    void trackedFree(void* p) {
+        if (!p) return;
+        noteFree();
+        std::free(p);
+    }
+
+    void trackedAlignedFree(void* p) {
+        if (!p) return;
+        noteFree();
+#ifdef _MSC_VER
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+#endif
+}
+
+namespace AllocTracker {
+    Counts GetThreadCounts() {
+        return threadCounts;
+    }
+
+    Counts GetTotalCounts() {
+        return { totalAllocations.load(std::memory_order_relaxed), totalBytes.load(std::memory_order_relaxed),
+                 totalFrees.load(std::memory_order_relaxed) };
+    }
+
+    size_t GetTags(std::array<TagCounts, MAX_TAGS>& out) {
+        size_t count = tagCount.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; i++) {
+            out[i].tag = tagSlots[i].tag.load(std::memory_order_relaxed);
+            out[i].counts = { tagSlots[i].allocations.load(std::memory_order_relaxed),
+                              tagSlots[i].bytes.load(std::memory_order_relaxed),
+                              tagSlots[i].frees.load(std::memory_order_relaxed) };
+        }
+        return count;
+    }
+
+    Scope::Scope(const char* tag) : previous(currentTag) {
+        if (COMPILED_IN) currentTag = tagIndex(tag);
+    }
+
+    Scope::~Scope() {
+        currentTag = previous;
+    }
+}
+
+#ifdef STARFALL_ALLOC_TRACKING
+void* operator new(size_t size) {
+    if (void* p = trackedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) {
+    if (void* p = trackedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return trackedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return trackedAlloc(size); }
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    if (void* p = trackedAlignedAlloc(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+    if (void* p = trackedAlignedAlloc(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return trackedAlignedAlloc(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return trackedAlignedAlloc(size, alignment); }
+
+void operator delete(void* p) noexcept { trackedFree(p); }
+void operator delete[](void* p) noexcept { trackedFree(p); }
+void operator delete(void* p, size_t) noexcept { trackedFree(p); }
+void operator delete[](void* p, size_t) noexcept { trackedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { trackedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { trackedFree(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { trackedAlignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { trackedAlignedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { trackedAlignedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { trackedAlignedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { trackedAlignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { trackedAlignedFree(p); }
+#endif
+
+AllocationMonitor::AllocationMonitor(uint64_t budgetPerFrame) : olc::PGEX(true), budget(budgetPerFrame) {}
+
+bool AllocationMonitor::OnBeforeUserUpdate(float&) {
+    if (!enabled) return false;
+
+    AllocTracker::Counts now = AllocTracker::GetThreadCounts();
+    std::array<AllocTracker::TagCounts, AllocTracker::MAX_TAGS> tags;
+    size_t tagTotal = AllocTracker::GetTags(tags);
+
+    if (started) {
+        lastFrame = now - frameStart;
+        lastFrameSteady = steady;
+        lastFrameTagCount = 0;
+        for (size_t i = 0; i < tagTotal; i++) {
+            AllocTracker::Counts delta = tags[i].counts - tagsAtStart[i].counts;
+            if (delta.allocations > 0) lastFrameTags[lastFrameTagCount++] = { tags[i].tag, delta };
+        }
+        std::sort(lastFrameTags.begin(), lastFrameTags.begin() + lastFrameTagCount,
+            [](const AllocTracker::TagCounts& a, const AllocTracker::TagCounts& b) { return a.counts.allocations > b.counts.allocations; });
+
+        if (steady) {
+            steadyFrames++;
+            peakSteady = std::max(peakSteady, lastFrame.allocations);
+            if (lastFrame.allocations > budget) overBudget++;
+        }
+    }
+
+    frameStart = now;
+    tagsAtStart = tags;
+    started = true;
+    return false;
+}
+
+void AllocationMonitor::OnAfterUserUpdate(float) {
+    if (!enabled) return;
+    if (pge->GetKey(olc::Key::F4).bPressed) ToggleOverlay();
+    if (overlay) drawOverlay();
+}
+
+// Drawing allocates too, so it is charged to its own tag rather than hidden
+void AllocationMonitor::drawOverlay() {
+    AllocTracker::Scope tagged("alloc overlay");
+
+    const int rows = int(std::min<size_t>(lastFrameTagCount, 8)) + 2;
+    const olc::vf2d origin = { float(pge->ScreenWidth() - 244), float(pge->ScreenHeight() - rows * 10 - 16) };
+    pge->FillRectDecal(origin, { 240.0f, float(rows * 10 + 12) }, olc::Pixel(0, 0, 0, 200));
+
+    std::ostringstream line;
+    line << "allocs/frame " << lastFrame.allocations << " (" << lastFrame.bytes / 1024 << " KB)";
+    bool over = lastFrameSteady && lastFrame.allocations > budget;
+    pge->DrawStringDecal(origin + olc::vf2d{ 4.0f, 4.0f }, line.str(), over ? olc::RED : olc::WHITE);
+
+    line.str("");
+    line << "budget " << budget << ", over " << overBudget << "/" << steadyFrames;
+    pge->DrawStringDecal(origin + olc::vf2d{ 4.0f, 14.0f }, line.str(), olc::GREY);
+
+    for (int i = 0; i + 2 < rows; i++) {
+        const auto& t = lastFrameTags[i];
+        line.str("");
+        line << t.counts.allocations << "  " << t.tag;
+        pge->DrawStringDecal(origin + olc::vf2d{ 4.0f, float(26 + i * 10) }, line.str(), olc::CYAN);
+    }
+}
+
+bool AllocationMonitor::Report() const {
+    if (!enabled || steadyFrames == 0) return true;
+
+    std::cout << "Allocations: peak " << peakSteady << " per gameplay frame over " << steadyFrames
+              << " frames, budget " << budget << std::endl;
+    if (overBudget > 0) {
+        std::cerr << "ERROR: " << overBudget << " gameplay frames went over the allocation budget of " << budget << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include "olcPixelGameEngine.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// ============================================================================
+// ALLOCATION TRACKER
+// ============================================================================
+// Counts heap allocations through a replacement global operator new/delete,
+// compiled in only when STARFALL_ALLOC_TRACKING is defined (the simulator
+// defines it; the game opts in per build). Without it the API stays the same
+// and every count reads zero, so callers need no #ifdefs.
+//
+// Counts are kept per thread and for the whole process. An AllocTracker::Scope
+// charges what its thread allocates while it is alive to a tag (the innermost
+// scope wins), so a frame's allocations can be traced to the code that made
+// them. Tags are string literals; up to MAX_TAGS distinct ones are kept.
+namespace AllocTracker {
+	constexpr size_t MAX_TAGS = 32;
+
+#ifdef STARFALL_ALLOC_TRACKING
+	constexpr bool COMPILED_IN = true;
+#else
+	constexpr bool COMPILED_IN = false;
+#endif
+
+	struct Counts {
+		uint64_t allocations = 0;
+		uint64_t bytes = 0;
+		uint64_t frees = 0;
+
+		Counts operator-(const Counts& earlier) const {
+			return { allocations - earlier.allocations, bytes - earlier.bytes, frees - earlier.frees };
+		}
+	};
+
+	struct TagCounts {
+		const char* tag = nullptr;
+		Counts counts;
+	};
+
+	// The calling thread since it started, and every thread together
+	Counts GetThreadCounts();
+	Counts GetTotalCounts();
+
+	// Running totals of every tag used so far, in first-use order; returns how many
+	size_t GetTags(std::array<TagCounts, MAX_TAGS>& out);
+
+	class Scope {
+	public:
+		explicit Scope(const char* tag);
+		~Scope();
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		int previous;
+	};
+}
+
+// Per-frame view of the engine thread's allocations: a PGEX that closes each
+// frame in OnBeforeUserUpdate and, when shown (F4), lists the last frame's
+// count per tag. Frames can be held to a budget while the owner says the
+// game is in steady state; the ones that go over are counted and reported.
+class AllocationMonitor : public olc::PGEX {
+public:
+	explicit AllocationMonitor(uint64_t budgetPerFrame);
+
+	void SetEnabled(bool on) { enabled = on; }
+	void ToggleOverlay() { overlay = !overlay; }
+
+	// Frames only count against the budget while this is on
+	void SetSteadyState(bool on) { steady = on; }
+
+	const AllocTracker::Counts& GetLastFrame() const { return lastFrame; }
+	uint64_t GetPeakSteadyFrame() const { return peakSteady; }
+	uint64_t GetSteadyFrames() const { return steadyFrames; }
+	uint64_t GetFramesOverBudget() const { return overBudget; }
+	uint64_t GetBudget() const { return budget; }
+
+	// Prints the steady-state summary; false if any frame went over budget
+	bool Report() const;
+
+protected:
+	bool OnBeforeUserUpdate(float& fElapsedTime) override;
+	void OnAfterUserUpdate(float fElapsedTime) override;
+
+private:
+	void drawOverlay();
+
+	uint64_t budget;
+	bool enabled = AllocTracker::COMPILED_IN;
+	bool overlay = false;
+	bool steady = false;
+	bool started = false;
+
+	AllocTracker::Counts frameStart;
+	AllocTracker::Counts lastFrame;
+	bool lastFrameSteady = false;
+	uint64_t steadyFrames = 0;
+	uint64_t peakSteady = 0;
+	uint64_t overBudget = 0;
+
+	std::array<AllocTracker::TagCounts, AllocTracker::MAX_TAGS> tagsAtStart{};
+	std::array<AllocTracker::TagCounts, AllocTracker::MAX_TAGS> lastFrameTags{};
+	size_t lastFrameTagCount = 0;
+};
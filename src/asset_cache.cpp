@@ -0,0 +1,201 @@
+#include "asset_cache.h"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+std::string AssetCache::canonicalKey(const std::string& path) {
+    std::error_code ec;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(path, ec);
+    return ec ? path : canonical.generic_string();
+}
+
+AssetCache::~AssetCache() {
+#ifdef _DEBUG
+    ReportLeaks();
+#endif
+}
+
+AssetCache::SpriteHandle AssetCache::findSprite(const std::string& key) const {
+    auto it = sprites.find(key);
+    return it != sprites.end() ? it->second.lock() : nullptr;
+}
+
+static size_t spriteBytes(const olc::Sprite& sprite) {
+    return size_t(sprite.width) * sprite.height * sizeof(olc::Pixel);
+}
+
+AssetCache::SpriteHandle AssetCache::adoptSprite(const std::string& key, SpriteAsset* asset) {
+    asset->bytes = spriteBytes(*asset->sprite);
+    residentBytes[size_t(AssetType::SPRITE)] += asset->bytes;
+    residentBytes[size_t(AssetType::DECAL)] += asset->bytes;
+
+    std::weak_ptr<AssetCache*> owner = self;
+    SpriteHandle handle(asset, [owner, key](SpriteAsset* a) {
+        if (auto cache = owner.lock()) {
+            (*cache)->residentBytes[size_t(AssetType::SPRITE)] -= a->bytes;
+            (*cache)->residentBytes[size_t(AssetType::DECAL)] -= a->bytes;
+            (*cache)->sprites.erase(key);
+        }
+        delete a;  // decal is declared after sprite, so it is released first
+    });
+    sprites[key] = handle;
+    return handle;
+}
+
+AssetCache::SpriteHandle AssetCache::LoadSprite(const std::string& path) {
+    return LoadSpriteBatch({ path }).front();
+}
+
+std::vector<AssetCache::SpriteHandle> AssetCache::LoadSpriteBatch(const std::vector<std::string>& paths) {
+    std::vector<SpriteHandle> handles(paths.size());
+    std::vector<std::pair<size_t, SpriteAsset*>> pending;
+    pending.reserve(paths.size());
+
+    // Pass 1: reuse cached entries, decode everything else on the CPU
+    for (size_t i = 0; i < paths.size(); i++) {
+        std::string key = canonicalKey(paths[i]);
+        if ((handles[i] = findSprite(key)))
+            continue;
+
+        // A path listed twice in the same batch is decoded once
+        auto dup = std::find_if(pending.begin(), pending.end(),
+            [&](const std::pair<size_t, SpriteAsset*>& p) { return canonicalKey(paths[p.first]) == key; });
+        if (dup != pending.end())
+            continue;
+
+        auto decodeStart = StartupProfiler::Clock::now();
+        auto* asset = new SpriteAsset();
+        asset->sprite = std::make_unique<olc::Sprite>(paths[i]);
+        asset->valid = asset->sprite->width > 0 && asset->sprite->height > 0;
+        pending.push_back({ i, asset });
+        Trace::Complete("sprite decode", decodeStart, StartupProfiler::Clock::now(), paths[i].c_str());
+
+        if (profiler) {
+            double ms = StartupProfiler::MsSince(decodeStart);
+            profiler->AddPhaseTime("sprite decode", ms);
+            profiler->RecordAsset(paths[i], "sprite", spriteBytes(*asset->sprite), ms);
+        }
+    }
+
+    // Pass 2: upload all new decals together
+    for (auto& [index, asset] : pending) {
+        auto uploadStart = StartupProfiler::Clock::now();
+        asset->decal = std::make_unique<olc::Decal>(asset->sprite.get());
+        handles[index] = adoptSprite(canonicalKey(paths[index]), asset);
+        Trace::Complete("decal upload", uploadStart, StartupProfiler::Clock::now(), paths[index].c_str());
+
+        if (profiler) {
+            double ms = StartupProfiler::MsSince(uploadStart);
+            profiler->AddPhaseTime("decal upload", ms);
+            profiler->RecordAsset(paths[index], "decal", asset->bytes, ms);
+        }
+    }
+
+    // Fill in the duplicates now that their first occurrence is cached
+    for (size_t i = 0; i < paths.size(); i++) {
+        if (!handles[i])
+            handles[i] = findSprite(canonicalKey(paths[i]));
+    }
+
+    return handles;
+}
+
+AssetCache::SoundHandle AssetCache::LoadSound(const std::string& path, bool stream) {
+    if (!audio) return nullptr;
+
+    std::string key = canonicalKey(path);
+
+    auto it = sounds.find(key);
+    if (it != sounds.end()) {
+        if (SoundHandle existing = it->second.handle.lock())
+            return existing;
+    }
+
+    auto loadStart = StartupProfiler::Clock::now();
+    int id = stream ? audio->LoadStream(path) : audio->LoadSound(path);
+    size_t bytes = size_t(audio->GetResidentBytes(id));
+    residentBytes[size_t(AssetType::SOUND)] += bytes;
+    Trace::Complete(stream ? "stream load" : "sound load", loadStart, StartupProfiler::Clock::now(), path.c_str());
+
+    if (profiler) {
+        double ms = StartupProfiler::MsSince(loadStart);
+        profiler->AddPhaseTime("audio load", ms);
+        profiler->RecordAsset(path, stream ? "stream" : "sound", bytes, ms);
+    }
+
+    std::weak_ptr<AssetCache*> owner = self;
+    SoundHandle handle(new int(id), [owner, key](const int* soundId) {
+        if (auto cache = owner.lock()) {
+            (*cache)->residentBytes[size_t(AssetType::SOUND)] -= (*cache)->sounds[key].bytes;
+            (*cache)->sounds.erase(key);
+            // Behind any command still queued for it, on the thread that plays it
+            if ((*cache)->audioQueue) (*cache)->audioQueue->Unload(*soundId);
+            else (*cache)->audio->UnloadSound(*soundId);
+        }
+        delete soundId;
+    });
+    sounds[key] = { handle, bytes, stream };
+    return handle;
+}
+
+bool AssetCache::ReplaceSprite(const std::string& path, olc::Sprite&& sprite) {
+    SpriteHandle asset = findSprite(canonicalKey(path));
+    if (!asset || sprite.width == 0 || sprite.height == 0) return false;
+
+    residentBytes[size_t(AssetType::SPRITE)] -= asset->bytes;
+    residentBytes[size_t(AssetType::DECAL)] -= asset->bytes;
+
+    *asset->sprite = std::move(sprite);
+    asset->decal->Update();
+    asset->valid = true;
+    asset->bytes = spriteBytes(*asset->sprite);
+
+    residentBytes[size_t(AssetType::SPRITE)] += asset->bytes;
+    residentBytes[size_t(AssetType::DECAL)] += asset->bytes;
+    return true;
+}
+
+bool AssetCache::ReloadSound(const std::string& path, olc::MiniAudio::DecodedSound&& decoded) {
+    auto it = sounds.find(canonicalKey(path));
+    if (!audio || it == sounds.end()) return false;
+
+    SoundHandle handle = it->second.handle.lock();
+    if (!handle) return false;
+
+    // Only waits for commands already queued; the decoding happened before this
+    if (audioQueue) audioQueue->Flush();
+    if (it->second.streamed) audio->ReloadSound(*handle);
+    else audio->ReplaceSoundData(*handle, std::move(decoded));
+
+    residentBytes[size_t(AssetType::SOUND)] -= it->second.bytes;
+    it->second.bytes = size_t(audio->GetResidentBytes(*handle));
+    residentBytes[size_t(AssetType::SOUND)] += it->second.bytes;
+    return true;
+}
+
+size_t AssetCache::GetLoadedCount(AssetType type) const {
+    switch (type) {
+        case AssetType::SPRITE:
+        case AssetType::DECAL:  return sprites.size();
+        case AssetType::SOUND:  return sounds.size();
+        default:                return 0;
+    }
+}
+
+void AssetCache::PrintReport() const {
+    std::cout << "Asset cache:" << std::endl;
+    std::cout << "  - Sprites: " << GetLoadedCount(AssetType::SPRITE) << " (" << GetResidentBytes(AssetType::SPRITE) / 1024 << " KB)" << std::endl;
+    std::cout << "  - Decals: " << GetLoadedCount(AssetType::DECAL) << " (" << GetResidentBytes(AssetType::DECAL) / 1024 << " KB)" << std::endl;
+    std::cout << "  - Sounds: " << GetLoadedCount(AssetType::SOUND) << " (" << GetResidentBytes(AssetType::SOUND) / 1024 << " KB)" << std::endl;
+}
+
+void AssetCache::ReportLeaks() const {
+    for (const auto& [key, asset] : sprites) {
+        if (!asset.expired())
+            std::cerr << "LEAK: sprite still referenced at shutdown: " << key << " (" << asset.use_count() << " handles)" << std::endl;
+    }
+    for (const auto& [key, sound] : sounds) {
+        if (!sound.handle.expired())
+            std::cerr << "LEAK: sound still referenced at shutdown: " << key << " (" << sound.handle.use_count() << " handles)" << std::endl;
+    }
+}
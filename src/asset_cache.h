@@ -0,0 +1,91 @@
+#pragma once
+#include "olcPixelGameEngine.h"
+#include "olcPGEX_MiniAudio.h"
+#include "audio_queue.h"
+#include "startup_profiler.h"
+
+#include <array>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================================
+// ASSET CACHE
+// ============================================================================
+// Loads each file once, keyed by its canonical path, and hands out shared
+// handles. The asset is freed when the last handle to it goes away. A handle
+// may outlive the cache: its sprite is still freed, but a sound is left for
+// the audio engine to unload at shutdown, since the engine may be gone too.
+enum class AssetType {
+	SPRITE,
+	DECAL,
+	SOUND,
+	COUNT
+};
+
+class AssetCache {
+public:
+	struct SpriteAsset {
+		std::unique_ptr<olc::Sprite> sprite;
+		std::unique_ptr<olc::Decal> decal;
+		bool valid = false;
+		size_t bytes = 0;
+	};
+
+	using SpriteHandle = std::shared_ptr<SpriteAsset>;
+	using SoundHandle = std::shared_ptr<const int>;  // MiniAudio sound ID
+
+	explicit AssetCache(olc::MiniAudio* audio = nullptr) : audio(audio) {}
+	~AssetCache();
+	AssetCache(const AssetCache&) = delete;
+	AssetCache& operator=(const AssetCache&) = delete;
+
+	// Optional: time and size every load into the given profiler
+	void SetProfiler(StartupProfiler* p) { profiler = p; }
+	// Optional: the queue that owns playback, flushed before a sound's data is swapped under it
+	// and given the unloads of released handles, so it must outlive every handle
+	void SetAudioQueue(AudioCommandQueue* q) { audioQueue = q; }
+
+	// Returns the cached sprite + decal for path, loading it on first use
+	SpriteHandle LoadSprite(const std::string& path);
+	// Same as LoadSprite for many paths: decodes every image first, then uploads all decals together
+	std::vector<SpriteHandle> LoadSpriteBatch(const std::vector<std::string>& paths);
+	// Returns the cached sound for path, loading (or streaming) it on first use
+	SoundHandle LoadSound(const std::string& path, bool stream = false);
+
+	// Hot reload: swap new pixels into a live sprite (and re-upload its decal) in place,
+	// so every existing Sprite*/Decal* stays valid. Returns false if path isn't loaded.
+	bool ReplaceSprite(const std::string& path, olc::Sprite&& sprite);
+	// Hot reload: swap a live sound's data, decoded off the engine thread, in under its MiniAudio ID.
+	// A stream has nothing decoded up front and just reopens its file, ignoring decoded
+	bool ReloadSound(const std::string& path, olc::MiniAudio::DecodedSound&& decoded);
+	bool IsSpriteLoaded(const std::string& path) const { return findSprite(canonicalKey(path)) != nullptr; }
+
+	size_t GetResidentBytes(AssetType type) const { return residentBytes[size_t(type)]; }
+	size_t GetLoadedCount(AssetType type) const;
+	void PrintReport() const;
+	// Lists every asset that still has live handles (run automatically on destruction in debug builds)
+	void ReportLeaks() const;
+
+private:
+	static std::string canonicalKey(const std::string& path);
+	SpriteHandle findSprite(const std::string& key) const;
+	SpriteHandle adoptSprite(const std::string& key, SpriteAsset* asset);
+
+	olc::MiniAudio* audio = nullptr;
+	StartupProfiler* profiler = nullptr;
+	AudioCommandQueue* audioQueue = nullptr;
+	std::unordered_map<std::string, std::weak_ptr<SpriteAsset>> sprites;
+	struct SoundEntry {
+		std::weak_ptr<const int> handle;
+		size_t bytes = 0;
+		bool streamed = false;
+	};
+
+	std::unordered_map<std::string, SoundEntry> sounds;
+	std::array<size_t, size_t(AssetType::COUNT)> residentBytes{};
+
+	// Handle deleters hold this weakly and only touch the cache while it is alive
+	std::shared_ptr<AssetCache*> self = std::make_shared<AssetCache*>(this);
+};
@@ -33,3 +33,16 @@ void Asteroid::Draw(olc::PixelGameEngine* pge) {
     }
 }
 
+void Asteroid::Save(SnapshotWriter& out) const {
+    out.Write(pos);
+    out.Write(vel);
+    out.Write(r);
+    out.Write(alive);
+}
+
+void Asteroid::Load(SnapshotReader& in) {
+    in.Read(pos);
+    in.Read(vel);
+    in.Read(r);
+    in.Read(alive);
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include "olcPixelGameEngine.h"
 #include "GameConfig.h"
+#include "snapshot.h"
 
 struct Asteroid {
 	olc::vf2d pos, vel;
@@ -12,4 +13,8 @@ struct Asteroid {
 	void Update(float dt, int screenH);
 	void Draw(olc::PixelGameEngine* pge);
 
+	// Snapshot hooks; the decal is re-linked by whoever restores
+	void Save(SnapshotWriter& out) const;
+	void Load(SnapshotReader& in);
+
 };
\ No newline at end of file
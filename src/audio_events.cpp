@@ -0,0 +1,100 @@
+#include "audio_events.h"
+#include <algorithm>
+#include <cmath>
+
+AudioEventAggregator::Entry& AudioEventAggregator::entry(int soundId) {
+    if (soundId >= int(entries.size())) {
+        entries.resize(soundId + 1);
+        // A sound is in each list at most once, so neither grows once every ID is known
+        pendingIds.reserve(entries.size());
+        cooling.reserve(entries.size());
+    }
+    return entries[soundId];
+}
+
+void AudioEventAggregator::SetRateLimit(int soundId, float seconds) {
+    if (soundId < 0) return;
+    entry(soundId).minInterval = std::max(0.0f, seconds);
+}
+
+void AudioEventAggregator::Reserve(int soundId) {
+    if (soundId >= 0) entry(soundId);
+}
+
+void AudioEventAggregator::Request(int soundId, float volume, float pan) {
+    if (soundId < 0) return;
+    stats.requested++;
+
+    Entry& e = entry(soundId);
+    if (!e.pending) {
+        e.pending = true;
+        pendingIds.push_back(soundId);
+    }
+    e.sumSquares += volume * volume;
+    e.panSum += pan * volume * volume;
+    e.maxVolume = std::max(e.maxVolume, volume);
+}
+
+void AudioEventAggregator::RequestAt(int soundId, int emitter, float volume) {
+    if (soundId < 0) return;
+    Request(soundId, volume);
+
+    Entry& e = entries[soundId];
+    if (volume >= e.emitterVolume) {
+        e.emitter = emitter;
+        e.emitterVolume = volume;
+    }
+}
+
+// Uncorrelated copies of a sound add in power, not amplitude: five 0.4 hits
+// land at ~0.9 rather than clipping at 2.0, and never quieter than the loudest
+float AudioEventAggregator::MergedVolume(float sumSquares, float maxVolume) {
+    return std::clamp(std::sqrt(sumSquares), maxVolume, 1.0f);
+}
+
+float AudioEventAggregator::MergedPan(float panSum, float sumSquares) {
+    if (sumSquares <= 0.0f) return 0.0f;
+    return std::clamp(panSum / sumSquares, -1.0f, 1.0f);
+}
+
+void AudioEventAggregator::Submit(AudioCommandQueue& queue, float dt) {
+    for (size_t i = 0; i < cooling.size(); ) {
+        Entry& e = entries[cooling[i]];
+        e.cooldown -= dt;
+        if (e.cooldown <= 0.0f) {
+            e.cooldown = 0.0f;
+            cooling[i] = cooling.back();
+            cooling.pop_back();
+            continue;
+        }
+        i++;
+    }
+
+    // Sounds still cooling down stay pending and keep merging into next frame's trigger
+    size_t kept = 0;
+    for (int id : pendingIds) {
+        Entry& e = entries[id];
+        if (e.cooldown > 0.0f) {
+            pendingIds[kept++] = id;
+            stats.deferred++;
+            continue;
+        }
+
+        float volume = MergedVolume(e.sumSquares, e.maxVolume);
+        if (e.emitter >= 0) queue.PlayVoiceAt(id, e.emitter, volume);
+        else queue.PlayVoice(id, volume, MergedPan(e.panSum, e.sumSquares));
+        stats.triggered++;
+
+        e.pending = false;
+        e.sumSquares = 0.0f;
+        e.maxVolume = 0.0f;
+        e.panSum = 0.0f;
+        e.emitter = -1;
+        e.emitterVolume = 0.0f;
+        if (e.minInterval > 0.0f) {
+            e.cooldown = e.minInterval;
+            cooling.push_back(id);
+        }
+    }
+    pendingIds.resize(kept);
+}
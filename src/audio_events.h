@@ -0,0 +1,65 @@
+#pragma once
+#include "audio_queue.h"
+
+#include <cstdint>
+#include <vector>
+
+// ============================================================================
+// AUDIO EVENT AGGREGATOR
+// ============================================================================
+// Collects one-shot play requests during a frame and submits them once at
+// the end of it. Requests for the same sound are merged into one trigger
+// whose volume follows a loudness curve, and each sound can be rate limited
+// so it never retriggers faster than a minimum interval. Merged requests
+// take the loudness-weighted average of their pans, so a frame's worth of
+// positional plays costs one voice and no per-call SetPan. Requests made at
+// an emitter instead follow the loudest one's emitter, whose pan and gain
+// the game moves in one batch per frame for as long as the voice plays.
+class AudioEventAggregator {
+public:
+	struct Stats {
+		uint64_t requested = 0;     // Request() calls
+		uint64_t triggered = 0;     // voices actually started
+		uint64_t deferred = 0;      // frames a merged event waited on a rate limit
+	};
+
+	// Minimum time between two triggers of a sound, 0 = no limit
+	void SetRateLimit(int soundId, float seconds);
+
+	// Makes room for every ID up to soundId now, so requesting them never allocates
+	void Reserve(int soundId);
+
+	// Queue a play of soundId for the end of this frame, pan -1 (left) .. 1 (right)
+	void Request(int soundId, float volume = 1.0f, float pan = 0.0f);
+	// Same, but the voice follows the emitter (see AudioCommandQueue::SetEmitter), which applies its gain on top
+	void RequestAt(int soundId, int emitter, float volume = 1.0f);
+
+	// Advance the rate limit timers by dt and submit this frame's merged events
+	void Submit(AudioCommandQueue& queue, float dt);
+
+	const Stats& GetStats() const { return stats; }
+
+	// Combined volume of merged requests, from their summed squared volumes and the loudest one
+	static float MergedVolume(float sumSquares, float maxVolume);
+	// Combined pan of merged requests, each weighted by its squared volume
+	static float MergedPan(float panSum, float sumSquares);
+
+private:
+	struct Entry {
+		float sumSquares = 0.0f;
+		float maxVolume = 0.0f;
+		float panSum = 0.0f;        // Pans weighted by squared volume
+		int emitter = -1;           // Of the loudest RequestAt, -1 if none
+		float emitterVolume = 0.0f;
+		float minInterval = 0.0f;
+		float cooldown = 0.0f;
+		bool pending = false;
+	};
+
+	Entry& entry(int soundId);
+
+	std::vector<Entry> entries;     // Indexed by MiniAudio sound ID
+	std::vector<int> pendingIds;    // Sounds requested since the last trigger
+	std::vector<int> cooling;       // Sounds with a rate limit timer running
+	Stats stats;
+};
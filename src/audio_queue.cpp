@@ -0,0 +1,275 @@
+#include "audio_queue.h"
+#include "trace.h"
+#include <iomanip>
+#include <iostream>
+
+AudioCommandQueue::~AudioCommandQueue() {
+    Shutdown();
+}
+
+void AudioCommandQueue::Start() {
+    if (running) return;
+    // Reaping unloads sounds, so it moves to the thread that plays them
+    audio.SetReapOnUpdate(false);
+    running = true;
+    worker = std::thread(&AudioCommandQueue::controlLoop, this);
+}
+
+void AudioCommandQueue::Shutdown() {
+    if (!running) return;
+    running = false;
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wake.notify_one();
+    }
+    if (worker.joinable()) worker.join();
+
+    // Anything enqueued after the thread's last pass still gets applied
+    Command cmd;
+    while (ring.Pop(cmd)) execute(cmd);
+    audio.SetReapOnUpdate(true);
+}
+
+void AudioCommandQueue::Play(int id, bool looping) {
+    Command cmd;
+    cmd.type = AudioCommandType::PLAY;
+    cmd.id = id;
+    cmd.looping = looping;
+    enqueue(cmd);
+}
+
+void AudioCommandQueue::PlayVoice(int id, float volume, float pan, float pitch) {
+    Command cmd;
+    cmd.type = AudioCommandType::PLAY_VOICE;
+    cmd.id = id;
+    cmd.volume = volume;
+    cmd.pan = pan;
+    cmd.pitch = pitch;
+    enqueue(cmd);
+}
+
+void AudioCommandQueue::PlayVoiceAt(int id, int emitter, float volume, float pitch) {
+    Command cmd;
+    cmd.type = AudioCommandType::PLAY_VOICE_AT;
+    cmd.id = id;
+    cmd.emitter = emitter;
+    cmd.volume = volume;
+    cmd.pitch = pitch;
+    enqueue(cmd);
+}
+
+void AudioCommandQueue::Stop(int id) {
+    Command cmd;
+    cmd.type = AudioCommandType::STOP;
+    cmd.id = id;
+    enqueue(cmd);
+}
+
+void AudioCommandQueue::Pause(int id) {
+    Command cmd;
+    cmd.type = AudioCommandType::PAUSE;
+    cmd.id = id;
+    enqueue(cmd);
+}
+
+void AudioCommandQueue::StopVoices(int id) {
+    Command cmd;
+    cmd.type = AudioCommandType::STOP_VOICES;
+    cmd.id = id;
+    enqueue(cmd);
+}
+
+void AudioCommandQueue::SetVolume(int id, float volume) {
+    Command cmd;
+    cmd.type = AudioCommandType::SET_VOLUME;
+    cmd.id = id;
+    cmd.volume = volume;
+    enqueue(cmd);
+}
+
+void AudioCommandQueue::SetPan(int id, float pan) {
+    Command cmd;
+    cmd.type = AudioCommandType::SET_PAN;
+    cmd.id = id;
+    cmd.pan = pan;
+    enqueue(cmd);
+}
+
+void AudioCommandQueue::SetPitch(int id, float pitch) {
+    Command cmd;
+    cmd.type = AudioCommandType::SET_PITCH;
+    cmd.id = id;
+    cmd.pitch = pitch;
+    enqueue(cmd);
+}
+
+void AudioCommandQueue::PlayWithFadeIn(int id, uint64_t startTime, uint64_t fadeFrames, bool looping) {
+    Command cmd;
+    cmd.type = AudioCommandType::FADE_IN;
+    cmd.id = id;
+    cmd.time = startTime;
+    cmd.frames = fadeFrames;
+    cmd.looping = looping;
+    enqueue(cmd);
+}
+
+void AudioCommandQueue::StopWithFadeOut(int id, uint64_t startTime, uint64_t fadeFrames) {
+    Command cmd;
+    cmd.type = AudioCommandType::FADE_OUT;
+    cmd.id = id;
+    cmd.time = startTime;
+    cmd.frames = fadeFrames;
+    enqueue(cmd);
+}
+
+void AudioCommandQueue::SetEmitter(int emitter, float pan, float gain) {
+    Command cmd;
+    cmd.type = AudioCommandType::SET_EMITTER;
+    cmd.emitter = emitter;
+    cmd.pan = pan;
+    cmd.volume = gain;
+    enqueue(cmd);
+}
+
+void AudioCommandQueue::UpdateEmitters() {
+    Command cmd;
+    cmd.type = AudioCommandType::UPDATE_EMITTERS;
+    enqueue(cmd);
+}
+
+void AudioCommandQueue::Unload(int id) {
+    Command cmd;
+    cmd.type = AudioCommandType::UNLOAD;
+    cmd.id = id;
+    enqueue(cmd);
+}
+
+void AudioCommandQueue::ReapFinished() {
+    Command cmd;
+    cmd.type = AudioCommandType::REAP_FINISHED;
+    enqueue(cmd);
+}
+
+void AudioCommandQueue::enqueue(Command cmd) {
+    if (!running) {
+        execute(cmd);
+        return;
+    }
+
+    cmd.enqueuedAt = Clock::now();
+    if (!ring.Push(cmd)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    enqueued.fetch_add(1, std::memory_order_relaxed);
+
+    size_t depth = ring.Size();
+    if (depth > peakDepth.load(std::memory_order_relaxed)) {
+        peakDepth.store(depth, std::memory_order_relaxed);
+    }
+
+    // Pairs with the fence in controlLoop: either the control thread sees the
+    // new command before sleeping, or we see it asleep and wake it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wake.notify_one();
+    }
+}
+
+void AudioCommandQueue::execute(const Command& cmd) {
+    // The latency probe times a play from when it was queued, so the hop to this thread counts
+    const bool isPlay = cmd.type == AudioCommandType::PLAY || cmd.type == AudioCommandType::PLAY_VOICE
+        || cmd.type == AudioCommandType::PLAY_VOICE_AT;
+    const bool queued = isPlay && cmd.enqueuedAt != Clock::time_point();
+    if (queued) audio.SetPlayRequestTime(cmd.enqueuedAt);
+
+    try {
+        switch (cmd.type) {
+        case AudioCommandType::PLAY:        audio.Play(cmd.id, cmd.looping); break;
+        case AudioCommandType::PLAY_VOICE:  audio.PlayVoice(cmd.id, cmd.volume, cmd.pan, cmd.pitch); break;
+        case AudioCommandType::PLAY_VOICE_AT: audio.PlayVoiceAt(cmd.id, cmd.emitter, cmd.volume, cmd.pitch); break;
+        case AudioCommandType::STOP:        audio.Stop(cmd.id); break;
+        case AudioCommandType::PAUSE:       audio.Pause(cmd.id); break;
+        case AudioCommandType::STOP_VOICES: audio.StopVoices(cmd.id); break;
+        case AudioCommandType::SET_VOLUME:  audio.SetVolume(cmd.id, cmd.volume); break;
+        case AudioCommandType::SET_PAN:     audio.SetPan(cmd.id, cmd.pan); break;
+        case AudioCommandType::SET_PITCH:   audio.SetPitch(cmd.id, cmd.pitch); break;
+        case AudioCommandType::FADE_IN:     audio.PlayWithFadeIn(cmd.id, cmd.time, cmd.frames, cmd.looping); break;
+        case AudioCommandType::FADE_OUT:    audio.StopWithFadeOut(cmd.id, cmd.time, cmd.frames); break;
+        case AudioCommandType::SET_EMITTER: audio.SetEmitter(cmd.emitter, cmd.pan, cmd.volume); break;
+        case AudioCommandType::UPDATE_EMITTERS: audio.UpdateEmitters(); break;
+        case AudioCommandType::UNLOAD:      audio.UnloadSound(cmd.id); break;
+        case AudioCommandType::REAP_FINISHED: audio.ReapFinishedSounds(); break;
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "ERROR: Audio command failed for sound " << cmd.id << ": " << e.what() << std::endl;
+    }
+
+    if (queued) audio.SetPlayRequestTime(Clock::time_point());
+}
+
+void AudioCommandQueue::controlLoop() {
+    Trace::SetThreadName("audio control");
+
+    while (running) {
+        Command cmd;
+        while (ring.Pop(cmd)) {
+            {
+                Trace::Scope traced("audio command");
+                execute(cmd);
+            }
+
+            uint64_t ns = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - cmd.enqueuedAt).count());
+            totalLatencyNs.fetch_add(ns, std::memory_order_relaxed);
+            if (ns > maxLatencyNs.load(std::memory_order_relaxed)) {
+                maxLatencyNs.store(ns, std::memory_order_relaxed);
+            }
+            executed.fetch_add(1, std::memory_order_release);
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // The timeout is only a safety net, enqueue() wakes us
+        wake.wait_for(lock, std::chrono::milliseconds(10), [&] { return !running || !ring.Empty(); });
+        sleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+void AudioCommandQueue::Flush() {
+    if (!running) return;
+
+    uint64_t target = enqueued.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        wake.notify_one();
+    }
+    while (executed.load(std::memory_order_acquire) < target) {
+        std::this_thread::yield();
+    }
+}
+
+AudioCommandQueue::Stats AudioCommandQueue::GetStats() const {
+    Stats stats;
+    stats.enqueued = enqueued.load(std::memory_order_relaxed);
+    stats.executed = executed.load(std::memory_order_relaxed);
+    stats.dropped = dropped.load(std::memory_order_relaxed);
+    stats.depth = ring.Size();
+    stats.peakDepth = peakDepth.load(std::memory_order_relaxed);
+    if (stats.executed > 0) {
+        stats.avgLatencyUs = totalLatencyNs.load(std::memory_order_relaxed) / 1000.0 / stats.executed;
+    }
+    stats.maxLatencyUs = maxLatencyNs.load(std::memory_order_relaxed) / 1000.0;
+    return stats;
+}
+
+void AudioCommandQueue::PrintStats() const {
+    Stats stats = GetStats();
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Audio commands: " << stats.executed << "/" << stats.enqueued << " applied, "
+              << stats.dropped << " dropped, peak depth " << stats.peakDepth << "/" << ring.MaxSize()
+              << ", latency avg " << stats.avgLatencyUs << " us, max " << stats.maxLatencyUs << " us" << std::endl;
+    std::cout << std::defaultfloat;
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include "olcPixelGameEngine.h"
+#include "olcPGEX_MiniAudio.h"
+#include "spsc_ring.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+// ============================================================================
+// AUDIO COMMAND QUEUE
+// ============================================================================
+// The game thread enqueues playback commands into a lock-free ring and a
+// dedicated audio control thread applies them to MiniAudio, so the update
+// loop never waits on miniaudio. Once started, all playback control should
+// go through here, unloads included, and finished one-shots are reaped on
+// the control thread too; call Flush() before touching MiniAudio directly.
+enum class AudioCommandType : uint8_t {
+	PLAY,
+	PLAY_VOICE,
+	PLAY_VOICE_AT,
+	STOP,
+	PAUSE,
+	STOP_VOICES,
+	SET_VOLUME,
+	SET_PAN,
+	SET_PITCH,
+	FADE_IN,
+	FADE_OUT,
+	SET_EMITTER,
+	UPDATE_EMITTERS,
+	UNLOAD,
+	REAP_FINISHED
+};
+
+class AudioCommandQueue {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	struct Stats {
+		uint64_t enqueued = 0;
+		uint64_t executed = 0;
+		uint64_t dropped = 0;       // commands lost to a full ring
+		size_t depth = 0;
+		size_t peakDepth = 0;
+		double avgLatencyUs = 0.0;  // enqueue to applied
+		double maxLatencyUs = 0.0;
+	};
+
+	explicit AudioCommandQueue(olc::MiniAudio& audio) : audio(audio) {}
+	~AudioCommandQueue();
+
+	// Until Start() is called commands are applied immediately on the calling thread.
+	// While running, MiniAudio no longer reaps finished sounds itself, see ReapFinished()
+	void Start();
+	void Shutdown();
+	bool IsRunning() const { return running; }
+
+	void Play(int id, bool looping = false);
+	void PlayVoice(int id, float volume = 1.0f, float pan = 0.0f, float pitch = 1.0f);
+	// A voice that follows the emitter's pan and gain while it plays
+	void PlayVoiceAt(int id, int emitter, float volume = 1.0f, float pitch = 1.0f);
+	void Stop(int id);
+	void Pause(int id);
+	void StopVoices(int id);
+	void SetVolume(int id, float volume);
+	void SetPan(int id, float pan);
+	void SetPitch(int id, float pitch);
+	// Scheduled fades, times are MiniAudio engine times in pcm frames
+	void PlayWithFadeIn(int id, uint64_t startTime, uint64_t fadeFrames, bool looping = false);
+	void StopWithFadeOut(int id, uint64_t startTime, uint64_t fadeFrames);
+	// Emitters move voices started with PlayVoiceAt: set the ones that changed this frame, then update them all at once
+	void SetEmitter(int emitter, float pan, float gain);
+	void UpdateEmitters();
+	void Unload(int id);
+	// Unloads the one-shots that have finished, once a frame
+	void ReapFinished();
+
+	// Blocks until every command enqueued so far has been applied
+	void Flush();
+
+	Stats GetStats() const;
+	void PrintStats() const;
+
+private:
+	struct Command {
+		AudioCommandType type = AudioCommandType::PLAY;
+		int id = -1;
+		int emitter = -1;
+		float volume = 1.0f;
+		float pan = 0.0f;
+		float pitch = 1.0f;
+		bool looping = false;
+		uint64_t time = 0;
+		uint64_t frames = 0;
+		Clock::time_point enqueuedAt;
+	};
+
+	static constexpr size_t CAPACITY = 256;
+
+	void enqueue(Command cmd);
+	void execute(const Command& cmd);
+	void controlLoop();
+
+	olc::MiniAudio& audio;
+	SpscRing<Command, CAPACITY> ring;
+
+	std::thread worker;
+	std::atomic<bool> running{ false };
+
+	// Only taken when the control thread is idle and needs waking
+	std::mutex wakeMutex;
+	std::condition_variable wake;
+	std::atomic<bool> sleeping{ false };
+
+	// Written by the game thread
+	std::atomic<uint64_t> enqueued{ 0 };
+	std::atomic<uint64_t> dropped{ 0 };
+	std::atomic<size_t> peakDepth{ 0 };
+	// Written by the control thread
+	std::atomic<uint64_t> executed{ 0 };
+	std::atomic<uint64_t> totalLatencyNs{ 0 };
+	std::atomic<uint64_t> maxLatencyNs{ 0 };
+};
@@ -1,6 +1,7 @@
 #pragma once
 #include "olcPixelGameEngine.h"
 #include "GameConfig.h"
+#include "snapshot.h"
 
 struct Bullet {
 	olc::vf2d pos;
@@ -9,6 +10,10 @@ struct Bullet {
 	bool alive = true;
 	olc::Decal* decal = nullptr;
 
+	// Snapshot hooks; the decal is re-linked by whoever restores
+	void Save(SnapshotWriter& out) const { out.Write(pos); out.Write(vel); out.Write(r); out.Write(alive); }
+	void Load(SnapshotReader& in) { in.Read(pos); in.Read(vel); in.Read(r); in.Read(alive); }
+
 	void Update(float dt) {
 		pos += vel * dt;
 		if (pos.y < -10.0f) alive = false;
@@ -0,0 +1,26 @@
+#pragma once
+#include "GameConfig.h"
+
+#include <vector>
+
+// ============================================================================
+// COLLISION
+// ============================================================================
+// The circle-vs-circle pass gameplay runs every tick: each live shot against
+// the live targets in order, stopping at the first one it touches. onHit(shot,
+// target) decides what a hit means; it is expected to kill the shot, and
+// usually the target, so a later shot in the same pass skips them.
+template <typename Shot, typename Target, typename OnHit>
+void CollideShots(std::vector<Shot>& shots, std::vector<Target>& targets, OnHit&& onHit) {
+	for (auto& s : shots) {
+		if (!s.alive) continue;
+		for (auto& t : targets) {
+			if (!t.alive) continue;
+			float hitR = s.r + t.r;
+			if (Dist2(s.pos, t.pos) <= hitR * hitR) {
+				onHit(s, t);
+				break;
+			}
+		}
+	}
+}
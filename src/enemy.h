@@ -2,6 +2,7 @@
 #include "olcPixelGameEngine.h"
 #include <random>
 #include "GameConfig.h"
+#include "snapshot.h"
 
 struct Enemy {
 	olc::vf2d pos;
@@ -11,6 +12,10 @@ struct Enemy {
 	bool inArena = false;
 	olc::Decal* decal = nullptr;  // Added for sprite rendering
 
+	// Snapshot hooks; the decal is re-linked by whoever restores
+	void Save(SnapshotWriter& out) const { out.Write(pos); out.Write(vel); out.Write(r); out.Write(alive); out.Write(inArena); }
+	void Load(SnapshotReader& in) { in.Read(pos); in.Read(vel); in.Read(r); in.Read(alive); in.Read(inArena); }
+
 	void Update(float dt, int screenW, int screenH) {
 		if (!alive) return;
 
@@ -2,6 +2,7 @@
 #include "olcPixelGameEngine.h"
 #include <cmath>
 #include "GameConfig.h"
+#include "snapshot.h"
 
 struct Boss {
 	olc::vf2d pos;
@@ -22,6 +23,16 @@ struct Boss {
 		inArena = false;
 	}
 
+	// Snapshot hooks; the decal is re-linked by whoever restores
+	void Save(SnapshotWriter& out) const {
+		out.Write(pos); out.Write(vel); out.Write(r); out.Write(maxHp); out.Write(hp);
+		out.Write(alive); out.Write(inArena); out.Write(targetY);
+	}
+	void Load(SnapshotReader& in) {
+		in.Read(pos); in.Read(vel); in.Read(r); in.Read(maxHp); in.Read(hp);
+		in.Read(alive); in.Read(inArena); in.Read(targetY);
+	}
+
 	void Update(float dt, int screenW) {
 		if (!alive) return;
 
@@ -0,0 +1,257 @@
+#include "frame_capture.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace FrameCapture {
+    namespace {
+        struct Color {
+            float r, g, b, a;
+        };
+
+        struct Vertex {
+            olc::vf2d pos;      // Screen pixels
+            olc::vf2d uv;       // Divided by q when sampled, as glTexCoord4f does
+            float q;
+            Color tint;
+        };
+
+        Color toColor(const olc::Pixel& p) {
+            return { p.r / 255.0f, p.g / 255.0f, p.b / 255.0f, p.a / 255.0f };
+        }
+
+        uint8_t toByte(float v) {
+            return uint8_t(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+
+        // Nearest texel, clamped to the edge; no texture reads as white like an unbound one
+        Color sample(const olc::Decal* decal, float u, float v) {
+            if (!decal || !decal->sprite || decal->sprite->width == 0) return { 1.0f, 1.0f, 1.0f, 1.0f };
+            const olc::Sprite* sprite = decal->sprite;
+            int x = std::clamp(int(std::floor(u * sprite->width)), 0, sprite->width - 1);
+            int y = std::clamp(int(std::floor(v * sprite->height)), 0, sprite->height - 1);
+            return toColor(sprite->pColData[size_t(y) * sprite->width + x]);
+        }
+
+        // The glBlendFunc each DecalMode sets in the GL renderers: out = src * sf + dst * df
+        void blend(olc::Pixel& dst, const Color& s, olc::DecalMode mode) {
+            const Color d = toColor(dst);
+            const float a = s.a;
+            Color sf, df;
+            const Color one = { 1.0f, 1.0f, 1.0f, 1.0f }, zero = { 0.0f, 0.0f, 0.0f, 0.0f };
+            const Color alpha = { a, a, a, a }, inverse = { 1.0f - a, 1.0f - a, 1.0f - a, 1.0f - a };
+            switch (mode) {
+            case olc::DecalMode::ADDITIVE:          sf = alpha;   df = one;     break;  // SRC_ALPHA, ONE
+            case olc::DecalMode::MULTIPLICATIVE:    sf = d;       df = inverse; break;  // DST_COLOR, ONE_MINUS_SRC_ALPHA
+            case olc::DecalMode::STENCIL:           sf = zero;    df = alpha;   break;  // ZERO, SRC_ALPHA
+            case olc::DecalMode::ILLUMINATE:        sf = inverse; df = alpha;   break;  // ONE_MINUS_SRC_ALPHA, SRC_ALPHA
+            default:                                sf = alpha;   df = inverse; break;  // SRC_ALPHA, ONE_MINUS_SRC_ALPHA
+            }
+            dst = olc::Pixel(toByte(s.r * sf.r + d.r * df.r), toByte(s.g * sf.g + d.g * df.g), toByte(s.b * sf.b + d.b * df.b), 255);
+        }
+
+        Color shade(const olc::Decal* decal, const olc::vf2d& uv, float q, const Color& tint) {
+            Color t = sample(decal, uv.x / q, uv.y / q);
+            return { t.r * tint.r, t.g * tint.g, t.b * tint.b, t.a * tint.a };
+        }
+
+        // Edge function: positive when p is to the right of a->b, in y-down screen space
+        float edge(const olc::vf2d& a, const olc::vf2d& b, const olc::vf2d& p) {
+            return (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x);
+        }
+
+        // Pixels exactly on an edge belong to one triangle only, so the two
+        // halves of a quad do not blend their shared diagonal twice
+        bool isTopLeft(const olc::vf2d& a, const olc::vf2d& b) {
+            float dx = b.x - a.x, dy = b.y - a.y;
+            return dy < 0.0f || (dy == 0.0f && dx > 0.0f);
+        }
+
+        void fillTriangle(olc::Sprite& out, const olc::DecalInstance& di, Vertex v0, Vertex v1, Vertex v2) {
+            float area = edge(v0.pos, v1.pos, v2.pos);
+            if (area == 0.0f) return;
+            if (area < 0.0f) {
+                std::swap(v1, v2);
+                area = -area;
+            }
+
+            int minX = std::max(0, int(std::floor(std::min({ v0.pos.x, v1.pos.x, v2.pos.x }))));
+            int maxX = std::min(out.width - 1, int(std::ceil(std::max({ v0.pos.x, v1.pos.x, v2.pos.x }))));
+            int minY = std::max(0, int(std::floor(std::min({ v0.pos.y, v1.pos.y, v2.pos.y }))));
+            int maxY = std::min(out.height - 1, int(std::ceil(std::max({ v0.pos.y, v1.pos.y, v2.pos.y }))));
+
+            const bool topLeft0 = isTopLeft(v1.pos, v2.pos);
+            const bool topLeft1 = isTopLeft(v2.pos, v0.pos);
+            const bool topLeft2 = isTopLeft(v0.pos, v1.pos);
+
+            for (int y = minY; y <= maxY; y++) {
+                for (int x = minX; x <= maxX; x++) {
+                    olc::vf2d p = { x + 0.5f, y + 0.5f };
+                    float w0 = edge(v1.pos, v2.pos, p);
+                    float w1 = edge(v2.pos, v0.pos, p);
+                    float w2 = edge(v0.pos, v1.pos, p);
+                    if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) continue;
+                    if ((w0 == 0.0f && !topLeft0) || (w1 == 0.0f && !topLeft1) || (w2 == 0.0f && !topLeft2)) continue;
+
+                    w0 /= area;
+                    w1 /= area;
+                    w2 /= area;
+                    olc::vf2d uv = v0.uv * w0 + v1.uv * w1 + v2.uv * w2;
+                    float q = v0.q * w0 + v1.q * w1 + v2.q * w2;
+                    Color tint = {
+                        v0.tint.r * w0 + v1.tint.r * w1 + v2.tint.r * w2,
+                        v0.tint.g * w0 + v1.tint.g * w1 + v2.tint.g * w2,
+                        v0.tint.b * w0 + v1.tint.b * w1 + v2.tint.b * w2,
+                        v0.tint.a * w0 + v1.tint.a * w1 + v2.tint.a * w2 };
+
+                    blend(out.pColData[size_t(y) * out.width + x], shade(di.decal, uv, q, tint), di.mode);
+                }
+            }
+        }
+
+        // Lines take the first vertex's colour; the game only uses them for debugging
+        void drawLine(olc::Sprite& out, const olc::DecalInstance& di, const Vertex& a, const Vertex& b) {
+            Color c = shade(di.decal, a.uv, a.q, a.tint);
+            int x0 = int(a.pos.x), y0 = int(a.pos.y), x1 = int(b.pos.x), y1 = int(b.pos.y);
+            int dx = std::abs(x1 - x0), dy = -std::abs(y1 - y0);
+            int sx = x0 < x1 ? 1 : -1, sy = y0 < y1 ? 1 : -1;
+            int err = dx + dy;
+            while (true) {
+                if (x0 >= 0 && y0 >= 0 && x0 < out.width && y0 < out.height)
+                    blend(out.pColData[size_t(y0) * out.width + x0], c, di.mode);
+                if (x0 == x1 && y0 == y1) break;
+                int e2 = 2 * err;
+                if (e2 >= dy) { err += dy; x0 += sx; }
+                if (e2 <= dx) { err += dx; y0 += sy; }
+            }
+        }
+
+        void drawDecal(olc::Sprite& out, const olc::DecalInstance& di) {
+            if (di.points < 2 || di.depth) return;
+
+            std::vector<Vertex> v(di.points);
+            for (uint32_t i = 0; i < di.points; i++) {
+                // Decal positions are in normalised device coordinates, y up
+                v[i].pos = { (di.pos[i].x + 1.0f) * 0.5f * out.width, (1.0f - di.pos[i].y) * 0.5f * out.height };
+                v[i].uv = di.uv[i];
+                v[i].q = i < di.w.size() ? di.w[i] : 1.0f;
+                v[i].tint = toColor(i < di.tint.size() ? di.tint[i] : olc::WHITE);
+            }
+
+            if (di.mode == olc::DecalMode::WIREFRAME) {
+                for (uint32_t i = 0; i < di.points; i++) drawLine(out, di, v[i], v[(i + 1) % di.points]);
+                return;
+            }
+
+            switch (di.structure) {
+            case olc::DecalStructure::FAN:
+                for (uint32_t i = 1; i + 1 < di.points; i++) fillTriangle(out, di, v[0], v[i], v[i + 1]);
+                break;
+            case olc::DecalStructure::STRIP:
+                for (uint32_t i = 0; i + 2 < di.points; i++) fillTriangle(out, di, v[i], v[i + 1], v[i + 2]);
+                break;
+            case olc::DecalStructure::LIST:
+                for (uint32_t i = 0; i + 2 < di.points; i += 3) fillTriangle(out, di, v[i], v[i + 1], v[i + 2]);
+                break;
+            case olc::DecalStructure::LINE:
+                for (uint32_t i = 0; i + 1 < di.points; i++) drawLine(out, di, v[i], v[i + 1]);
+                break;
+            }
+        }
+    }
+
+    void Composite(olc::PixelGameEngine& pge, olc::Sprite& out) {
+        if (out.width != pge.ScreenWidth() || out.height != pge.ScreenHeight()) out.SetSize(pge.ScreenWidth(), pge.ScreenHeight());
+        std::fill(out.pColData.begin(), out.pColData.end(), olc::BLACK);
+
+        // The layer quad goes down first, alpha blended over the cleared buffer
+        olc::LayerDesc& layer = pge.GetLayers()[0];
+        const olc::Sprite* target = layer.pDrawTarget.Sprite();
+        if (target && target->width == out.width && target->height == out.height) {
+            const Color tint = toColor(layer.tint);
+            for (size_t i = 0; i < out.pColData.size(); i++) {
+                Color c = toColor(target->pColData[i]);
+                blend(out.pColData[i], { c.r * tint.r, c.g * tint.g, c.b * tint.b, c.a * tint.a }, olc::DecalMode::NORMAL);
+            }
+        }
+
+        for (const auto& di : layer.vecDecalInstance) drawDecal(out, di);
+    }
+
+    bool SavePPM(const std::string& path, const olc::Sprite& image) {
+        std::error_code ec;
+        std::filesystem::path parent = std::filesystem::path(path).parent_path();
+        if (!parent.empty()) std::filesystem::create_directories(parent, ec);
+
+        std::ofstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "ERROR: Could not write frame: " << path << std::endl;
+            return false;
+        }
+
+        file << "P6\n" << image.width << " " << image.height << "\n255\n";
+        std::vector<uint8_t> row(size_t(image.width) * 3);
+        for (int y = 0; y < image.height; y++) {
+            for (int x = 0; x < image.width; x++) {
+                const olc::Pixel& p = image.pColData[size_t(y) * image.width + x];
+                row[x * 3 + 0] = p.r;
+                row[x * 3 + 1] = p.g;
+                row[x * 3 + 2] = p.b;
+            }
+            file.write(reinterpret_cast<const char*>(row.data()), std::streamsize(row.size()));
+        }
+        return bool(file);
+    }
+
+    bool LoadPPM(const std::string& path, olc::Sprite& image) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) return false;
+
+        std::string magic;
+        int width = 0, height = 0, maxValue = 0;
+        file >> magic >> width >> height >> maxValue;
+        file.get();     // The single whitespace before the pixels
+        if (magic != "P6" || width <= 0 || height <= 0 || maxValue != 255) {
+            std::cerr << "ERROR: Not an 8-bit binary PPM: " << path << std::endl;
+            return false;
+        }
+
+        image.SetSize(width, height);
+        std::vector<uint8_t> row(size_t(width) * 3);
+        for (int y = 0; y < height; y++) {
+            if (!file.read(reinterpret_cast<char*>(row.data()), std::streamsize(row.size()))) {
+                std::cerr << "ERROR: Truncated PPM: " << path << std::endl;
+                return false;
+            }
+            for (int x = 0; x < width; x++) {
+                image.pColData[size_t(y) * width + x] = olc::Pixel(row[x * 3 + 0], row[x * 3 + 1], row[x * 3 + 2]);
+            }
+        }
+        return true;
+    }
+
+    Diff Compare(const olc::Sprite& expected, const olc::Sprite& actual, int tolerance, olc::Sprite* diffImage) {
+        Diff diff;
+        if (expected.width != actual.width || expected.height != actual.height) {
+            diff.sizeMismatch = true;
+            return diff;
+        }
+
+        if (diffImage) diffImage->SetSize(actual.width, actual.height);
+        for (size_t i = 0; i < actual.pColData.size(); i++) {
+            const olc::Pixel& e = expected.pColData[i];
+            const olc::Pixel& a = actual.pColData[i];
+            int delta = std::max({ std::abs(e.r - a.r), std::abs(e.g - a.g), std::abs(e.b - a.b) });
+            diff.maxDelta = std::max(diff.maxDelta, delta);
+            if (delta > tolerance) diff.pixels++;
+
+            if (diffImage) {
+                diffImage->pColData[i] = delta > tolerance ? olc::RED : olc::Pixel(a.r / 4, a.g / 4, a.b / 4);
+            }
+        }
+        return diff;
+    }
+}
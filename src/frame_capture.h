@@ -0,0 +1,38 @@
+#pragma once
+#include "olcPixelGameEngine.h"
+
+#include <string>
+
+// ============================================================================
+// FRAME CAPTURE
+// ============================================================================
+// A CPU stand-in for the GL renderers, for headless builds whose renderer
+// draws nothing. Composite takes layer 0 as the engine left it at the end of
+// a frame, its draw target plus the decals queued on it, and rasterises them
+// into a sprite in the order and with the blend equations the GL renderers
+// use: nearest texel sampling, per-vertex tint, and each DecalMode's blend
+// function. It has to run before the engine's own render pass, which clears
+// the decal list.
+//
+// Depth-tested decals and GPU tasks are ignored; the game uses neither.
+//
+// Frames are saved as binary PPM (P6), which any image viewer opens, and
+// compared channel by channel so small rounding differences between
+// compilers and CPUs can be tolerated.
+namespace FrameCapture {
+	// Sized to the screen; out is resized if it does not match
+	void Composite(olc::PixelGameEngine& pge, olc::Sprite& out);
+
+	// RGB only; alpha is dropped on save and read back as 255. Saving creates the directory.
+	bool SavePPM(const std::string& path, const olc::Sprite& image);
+	bool LoadPPM(const std::string& path, olc::Sprite& image);
+
+	struct Diff {
+		int pixels = 0;             // Pixels with any channel off by more than the tolerance
+		int maxDelta = 0;           // Largest channel difference anywhere
+		bool sizeMismatch = false;
+	};
+
+	// Optionally fills diffImage with the differing pixels in red over a dimmed copy of actual
+	Diff Compare(const olc::Sprite& expected, const olc::Sprite& actual, int tolerance, olc::Sprite* diffImage = nullptr);
+}
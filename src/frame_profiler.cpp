@@ -0,0 +1,188 @@
+#include "frame_profiler.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace {
+    constexpr float OVERLAY_FULL_BAR_MS = 1000.0f / 60.0f;  // A bar across the whole width is one 60 Hz frame
+    constexpr int OVERLAY_BAR_WIDTH = 160;
+    constexpr int OVERLAY_ROW_HEIGHT = 10;
+    constexpr int OVERLAY_REFRESH_FRAMES = 15;
+
+    float toMs(FrameProfiler::Clock::duration d) {
+        return std::chrono::duration<float, std::milli>(d).count();
+    }
+}
+
+FrameProfiler::FrameProfiler(size_t frames) : olc::PGEX(true), ring(std::max<size_t>(frames, 2)) {}
+
+const char* FrameProfiler::PhaseName(FramePhase phase) {
+    switch (phase) {
+        case FramePhase::INPUT:         return "input";
+        case FramePhase::SPAWN:         return "spawn";
+        case FramePhase::INTEGRATE:     return "integrate";
+        case FramePhase::COLLIDE:       return "collide";
+        case FramePhase::CLEANUP:       return "cleanup";
+        case FramePhase::DRAW_ENTITIES: return "draw_entities";
+        case FramePhase::DRAW_HUD:      return "draw_hud";
+        case FramePhase::OTHER:         return "other";
+        case FramePhase::LAYER_UPLOAD:  return "layer_upload";
+        case FramePhase::PRESENT:       return "present";
+        default:                        return "?";
+    }
+}
+
+FramePhase FrameProfiler::Enter(FramePhase phase) {
+    FramePhase previous = current;
+    if (!enabled || !inFrame) return previous;
+
+    auto now = Clock::now();
+    ring[head].ms[size_t(current)] += toMs(now - since);
+    if (current != FramePhase::OTHER) Trace::Complete(PhaseName(current), since, now);
+    since = now;
+    current = phase;
+    return previous;
+}
+
+bool FrameProfiler::OnBeforeUserUpdate(float& fElapsedTime) {
+    if (!enabled) return false;
+    const auto& core = pge->GetCoreTimings();
+    auto now = Clock::now();
+
+    // The engine uploads and presents after OnAfterUserUpdate, so those times (and the
+    // frame's full length) only arrive now, for the frame before this one
+    if (count > 0) {
+        Frame& last = ring[head];
+        last.ms[size_t(FramePhase::LAYER_UPLOAD)] = core.fLayerUpload * 1000.0f;
+        last.ms[size_t(FramePhase::PRESENT)] = core.fPresent * 1000.0f;
+        last.frameMs = fElapsedTime * 1000.0f;
+
+        // The engine only reports durations; its upload and present ran back to back,
+        // ending just before this frame's input scan
+        if (Trace::IsActive()) {
+            auto seconds = [](float s) { return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(s)); };
+            auto presentEnd = now - seconds(core.fInput);
+            auto uploadEnd = presentEnd - seconds(core.fPresent);
+            Trace::Complete("layer_upload", uploadEnd - seconds(core.fLayerUpload), uploadEnd);
+            Trace::Complete("present", uploadEnd, presentEnd);
+            Trace::Complete("input", presentEnd, now);
+            Trace::Complete("frame", frameStart, now);
+        }
+    }
+    frameStart = now;
+
+    head = (head + 1) % ring.size();
+    count = std::min(count + 1, ring.size());
+    frameNumber++;
+
+    ring[head] = Frame{};
+    ring[head].ms[size_t(FramePhase::INPUT)] = core.fInput * 1000.0f;
+
+    current = FramePhase::OTHER;
+    since = now;
+    inFrame = true;
+    return false;
+}
+
+void FrameProfiler::OnAfterUserUpdate(float) {
+    if (!enabled) return;
+    Enter(FramePhase::OTHER);
+    inFrame = false;
+
+    if (pge->GetKey(olc::Key::F3).bPressed) ToggleOverlay();
+    if (overlay) drawOverlay();
+}
+
+template <typename Get>
+FrameProfiler::PhaseStats FrameProfiler::stats(Get get) const {
+    PhaseStats result;
+    if (count < 2) return result;
+
+    std::vector<float> values;
+    values.reserve(count - 1);
+    for (size_t age = 1; age < count; age++) values.push_back(get(slot(age)));
+
+    auto at = [&](double p) {
+        auto nth = values.begin() + std::min(values.size() - 1, size_t(p * values.size()));
+        std::nth_element(values.begin(), nth, values.end());
+        return *nth;
+    };
+    result.p50 = at(0.50);
+    result.p99 = at(0.99);
+    result.max = *std::max_element(values.begin(), values.end());
+    return result;
+}
+
+FrameProfiler::PhaseStats FrameProfiler::GetStats(FramePhase phase) const {
+    return stats([phase](const Frame& f) { return f.ms[size_t(phase)]; });
+}
+
+FrameProfiler::PhaseStats FrameProfiler::GetFrameStats() const {
+    return stats([](const Frame& f) { return f.frameMs; });
+}
+
+// Drawn as decals, so it lands on top of the game's own sprites
+void FrameProfiler::drawOverlay() {
+    if (--framesUntilStats <= 0) {
+        for (size_t p = 0; p < PHASES; p++) shownStats[p] = GetStats(FramePhase(p));
+        shownFrameStats = GetFrameStats();
+        framesUntilStats = OVERLAY_REFRESH_FRAMES;
+    }
+
+    const int labelWidth = 96;
+    const int rows = int(PHASES) + 1;
+    const int width = labelWidth + OVERLAY_BAR_WIDTH + 96;
+    const olc::vf2d origin = { 4.0f, float(pge->ScreenHeight() - rows * OVERLAY_ROW_HEIGHT - 16) };
+
+    pge->FillRectDecal(origin, { float(width), float(rows * OVERLAY_ROW_HEIGHT + 12) }, olc::Pixel(0, 0, 0, 200));
+    pge->DrawStringDecal(origin + olc::vf2d{ 4.0f, 3.0f }, "ms  p50 (bar) / p99 (tick), full bar = 16.7", olc::GREY);
+
+    auto row = [&](int index, const char* name, const PhaseStats& s, olc::Pixel colour) {
+        olc::vf2d pos = origin + olc::vf2d{ 4.0f, float(13 + index * OVERLAY_ROW_HEIGHT) };
+        auto barLength = [](float ms) { return std::min(1.0f, ms / OVERLAY_FULL_BAR_MS) * OVERLAY_BAR_WIDTH; };
+
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(2) << s.p50 << "/" << s.p99;
+
+        pge->DrawStringDecal(pos, name, olc::WHITE);
+        olc::vf2d bar = pos + olc::vf2d{ float(labelWidth), 0.0f };
+        pge->FillRectDecal(bar, { float(OVERLAY_BAR_WIDTH), 7.0f }, olc::Pixel(40, 40, 40));
+        pge->FillRectDecal(bar, { barLength(s.p50), 7.0f }, colour);
+        pge->FillRectDecal(bar + olc::vf2d{ barLength(s.p99), 0.0f }, { 1.0f, 7.0f }, olc::WHITE);
+        pge->DrawStringDecal(bar + olc::vf2d{ float(OVERLAY_BAR_WIDTH + 4), 0.0f }, text.str(), olc::WHITE);
+    };
+
+    for (size_t p = 0; p < PHASES; p++) {
+        olc::Pixel colour = p <= size_t(FramePhase::CLEANUP) ? olc::GREEN
+                          : p <= size_t(FramePhase::DRAW_HUD) ? olc::CYAN
+                          : p == size_t(FramePhase::OTHER) ? olc::GREY : olc::YELLOW;
+        row(int(p), PhaseName(FramePhase(p)), shownStats[p], colour);
+    }
+    row(int(PHASES), "frame", shownFrameStats, olc::MAGENTA);
+}
+
+bool FrameProfiler::WriteCsv(const std::string& path) const {
+    if (count < 2) return false;
+
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "ERROR: Could not write frame profile: " << path << std::endl;
+        return false;
+    }
+
+    file << "frame,frame_ms";
+    for (size_t p = 0; p < PHASES; p++) file << "," << PhaseName(FramePhase(p)) << "_ms";
+    file << "\n" << std::fixed << std::setprecision(4);
+
+    for (size_t age = count - 1; age >= 1; age--) {
+        const Frame& f = slot(age);
+        file << (frameNumber - age) << "," << f.frameMs;
+        for (float ms : f.ms) file << "," << ms;
+        file << "\n";
+    }
+
+    std::cout << "Frame profile (" << count - 1 << " frames) written to: " << path << std::endl;
+    return bool(file);
+}
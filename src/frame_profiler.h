@@ -0,0 +1,111 @@
+#pragma once
+#include "olcPixelGameEngine.h"
+#include "trace.h"
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// FRAME PROFILER
+// ============================================================================
+// Splits every frame into phases and keeps the last N frames in a ring.
+// Exactly one phase is current at a time: entering a phase charges the time
+// since the last switch to the one being left, so nested scopes and phase
+// switches inside a function cost one clock read each. Time nobody claimed
+// lands in OTHER. The engine's own work (input scan, layer upload, present)
+// comes from olc::PixelGameEngine::GetCoreTimings.
+//
+// Hooks into the engine as a PGEX: frames begin in OnBeforeUserUpdate, end
+// in OnAfterUserUpdate, which also draws the p50/p99 overlay when shown.
+// While tracing, every frame and every claimed phase also goes on the
+// engine thread's timeline.
+enum class FramePhase {
+	INPUT,
+	SPAWN,
+	INTEGRATE,
+	COLLIDE,
+	CLEANUP,
+	DRAW_ENTITIES,
+	DRAW_HUD,
+	OTHER,
+	LAYER_UPLOAD,
+	PRESENT,
+	COUNT
+};
+
+class FrameProfiler : public olc::PGEX {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	// Makes a phase current until destroyed, then hands back to the one before
+	class Scope {
+	public:
+		Scope(FrameProfiler& profiler, FramePhase phase) : profiler(profiler), previous(profiler.Enter(phase)) {}
+		~Scope() { profiler.Enter(previous); }
+		// Moves the rest of this scope to another phase
+		void Switch(FramePhase phase) { profiler.Enter(phase); }
+	private:
+		FrameProfiler& profiler;
+		FramePhase previous;
+	};
+
+	struct PhaseStats {
+		float p50 = 0.0f;
+		float p99 = 0.0f;
+		float max = 0.0f;
+	};
+
+	explicit FrameProfiler(size_t frames);
+
+	// Disabled, no clock is read at all (the simulator runs with it off)
+	void SetEnabled(bool on) { enabled = on; }
+	void SetOverlay(bool on) { overlay = on; }
+	void ToggleOverlay() { overlay = !overlay; }
+
+	// Makes phase current, returning the one that was
+	FramePhase Enter(FramePhase phase);
+
+	// Over the finished frames in the ring, in milliseconds
+	PhaseStats GetStats(FramePhase phase) const;
+	PhaseStats GetFrameStats() const;
+
+	// One row per frame in the ring, oldest first
+	bool WriteCsv(const std::string& path) const;
+
+	static const char* PhaseName(FramePhase phase);
+
+protected:
+	bool OnBeforeUserUpdate(float& fElapsedTime) override;
+	void OnAfterUserUpdate(float fElapsedTime) override;
+
+private:
+	static constexpr size_t PHASES = size_t(FramePhase::COUNT);
+
+	struct Frame {
+		float frameMs = 0.0f;
+		std::array<float, PHASES> ms{};
+	};
+
+	const Frame& slot(size_t age) const { return ring[(head + ring.size() - age) % ring.size()]; }
+	template <typename Get>
+	PhaseStats stats(Get get) const;
+	void drawOverlay();
+
+	std::vector<Frame> ring;
+	size_t head = 0;                    // Slot of the frame in progress
+	size_t count = 0;                   // Slots in use, the frame in progress included
+	uint64_t frameNumber = 0;
+	bool enabled = true;
+	bool overlay = false;
+	bool inFrame = false;
+
+	FramePhase current = FramePhase::OTHER;
+	Clock::time_point since;
+	Clock::time_point frameStart;
+
+	std::array<PhaseStats, PHASES> shownStats{};
+	PhaseStats shownFrameStats;
+	int framesUntilStats = 0;           // The overlay's percentiles refresh a few times a second
+};
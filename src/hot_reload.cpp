@@ -0,0 +1,176 @@
+#include "hot_reload.h"
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+AssetHotReload::AssetHotReload(AssetCache& cache) : olc::PGEX(true), cache(cache) {}
+
+AssetHotReload::~AssetHotReload() {
+    Stop();
+}
+
+bool AssetHotReload::isImage(const fs::path& path) {
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".bmp";
+}
+
+bool AssetHotReload::isSound(const fs::path& path) {
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == ".wav" || ext == ".mp3";
+}
+
+bool AssetHotReload::Start(const std::string& rootDir) {
+    if (running) return true;
+
+    std::error_code ec;
+    if (!fs::is_directory(rootDir, ec)) {
+        std::cerr << "ERROR: Hot reload directory not found: " << rootDir << std::endl;
+        return false;
+    }
+    root = rootDir;
+
+#if defined(__linux__)
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0) {
+        std::cerr << "ERROR: inotify_init1 failed, hot reload disabled" << std::endl;
+        return false;
+    }
+
+    auto addWatch = [&](const std::string& dir) {
+        int wd = inotify_add_watch(inotifyFd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd >= 0) watchDirs[wd] = dir;
+    };
+    addWatch(root);
+    for (const auto& entry : fs::recursive_directory_iterator(root, ec)) {
+        if (entry.is_directory()) addWatch(entry.path().generic_string());
+    }
+#else
+    for (const auto& entry : fs::recursive_directory_iterator(root, ec)) {
+        if (entry.is_regular_file()) lastWriteTimes[entry.path().generic_string()] = entry.last_write_time();
+    }
+#endif
+
+    running = true;
+    worker = std::thread(&AssetHotReload::watchLoop, this);
+    std::cout << "Hot reload watching: " << root << std::endl;
+    return true;
+}
+
+void AssetHotReload::Stop() {
+    if (!running) return;
+    running = false;
+    if (worker.joinable()) worker.join();
+
+#if defined(__linux__)
+    close(inotifyFd);
+    inotifyFd = -1;
+    watchDirs.clear();
+#endif
+}
+
+void AssetHotReload::watchLoop() {
+    Trace::SetThreadName("asset watcher");
+#if defined(__linux__)
+    alignas(inotify_event) char buffer[4096];
+
+    while (running) {
+        pollfd pfd{ inotifyFd, POLLIN, 0 };
+        if (poll(&pfd, 1, 250) <= 0) continue;
+
+        ssize_t len = read(inotifyFd, buffer, sizeof(buffer));
+        for (ssize_t offset = 0; offset < len; ) {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += sizeof(inotify_event) + event->len;
+
+            auto dir = watchDirs.find(event->wd);
+            if (event->len == 0 || dir == watchDirs.end()) continue;
+            onFileChanged(dir->second + "/" + event->name);
+        }
+    }
+#else
+    while (running) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+
+        std::error_code ec;
+        for (const auto& entry : fs::recursive_directory_iterator(root, ec)) {
+            if (!entry.is_regular_file()) continue;
+
+            std::string path = entry.path().generic_string();
+            auto stamp = entry.last_write_time(ec);
+            auto it = lastWriteTimes.find(path);
+            if (it != lastWriteTimes.end() && it->second == stamp) continue;
+
+            bool isNew = (it == lastWriteTimes.end());
+            lastWriteTimes[path] = stamp;
+            if (!isNew) onFileChanged(path);
+        }
+    }
+#endif
+}
+
+// Runs on the watcher thread: do the expensive decode here, never touch the cache
+void AssetHotReload::onFileChanged(const std::string& path) {
+    Trace::Scope traced("hot reload decode", path);
+    Reload reload;
+    reload.path = path;
+
+    if (isImage(path)) {
+        reload.sprite = std::make_unique<olc::Sprite>(path);
+        if (reload.sprite->width == 0 || reload.sprite->height == 0) {
+            std::cerr << "ERROR: Hot reload could not decode: " << path << std::endl;
+            return;
+        }
+    }
+    else if (isSound(path)) {
+        if (!olc::MiniAudio::DecodeFile(path, reload.sound)) {
+            std::cerr << "ERROR: Hot reload could not decode: " << path << std::endl;
+            return;
+        }
+    }
+    else {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    // A file saved twice before the next frame only needs the latest version
+    pending.erase(std::remove_if(pending.begin(), pending.end(),
+        [&](const Reload& r) { return r.path == path; }), pending.end());
+    pending.push_back(std::move(reload));
+}
+
+// Runs on the engine thread at the start of a frame
+bool AssetHotReload::OnBeforeUserUpdate(float&) {
+    std::vector<Reload> ready;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        if (pending.empty()) return false;
+        ready.swap(pending);
+    }
+
+    for (auto& reload : ready) {
+        try {
+            bool swapped = reload.sprite
+                ? cache.ReplaceSprite(reload.path, std::move(*reload.sprite))
+                : cache.ReloadSound(reload.path, std::move(reload.sound));
+
+            if (swapped) {
+                std::cout << "Hot reloaded: " << reload.path << std::endl;
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << "ERROR: Hot reload failed for " << reload.path << ": " << e.what() << std::endl;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "olcPixelGameEngine.h"
+#include "asset_cache.h"
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================================
+// ASSET HOT RELOAD
+// ============================================================================
+// Watches a directory tree on a background thread (inotify on Linux, polling
+// modification times elsewhere). Changed images and sounds are decoded on
+// that thread; the new pixels and samples are swapped into the AssetCache at
+// the next frame boundary from OnBeforeUserUpdate, on the engine thread.
+class AssetHotReload : public olc::PGEX {
+public:
+	explicit AssetHotReload(AssetCache& cache);
+	~AssetHotReload();
+
+	bool Start(const std::string& rootDir);
+	void Stop();
+	bool IsRunning() const { return running; }
+
+protected:
+	bool OnBeforeUserUpdate(float& fElapsedTime) override;
+
+private:
+	struct Reload {
+		std::string path;
+		std::unique_ptr<olc::Sprite> sprite;  // nullptr for sounds
+		olc::MiniAudio::DecodedSound sound;
+	};
+
+	void watchLoop();
+	void onFileChanged(const std::string& path);
+	static bool isImage(const std::filesystem::path& path);
+	static bool isSound(const std::filesystem::path& path);
+
+	AssetCache& cache;
+	std::string root;
+	std::thread worker;
+	std::atomic<bool> running{ false };
+
+	std::mutex pendingMutex;
+	std::vector<Reload> pending;
+
+#if defined(__linux__)
+	int inotifyFd = -1;
+	std::unordered_map<int, std::string> watchDirs;
+#else
+	std::unordered_map<std::string, std::filesystem::file_time_type> lastWriteTimes;
+#endif
+};
@@ -0,0 +1,55 @@
+#include "music_manager.h"
+#include <iostream>
+
+uint64_t MusicManager::scheduleTime() {
+    uint64_t sampleRate = ma_engine_get_sample_rate(audio.GetEngine());
+    return audio.GetEngineTimeInPcmFrames() + SCHEDULE_LEAD_MS * sampleRate / 1000;
+}
+
+uint64_t MusicManager::fadeFrames() {
+    return uint64_t(fadeSeconds * ma_engine_get_sample_rate(audio.GetEngine()));
+}
+
+void MusicManager::Play(int trackId) {
+    if (trackId < 0) return;
+    if (trackId == current && (state == State::FADING_IN || state == State::PLAYING)) return;
+
+    uint64_t at = scheduleTime();
+    uint64_t frames = fadeFrames();
+
+    if (current != -1 && current != trackId) {
+        queue.StopWithFadeOut(current, at, frames);
+    }
+    queue.SetVolume(trackId, volume);
+    queue.PlayWithFadeIn(trackId, at, frames, true);
+
+    std::cout << "Playing music: " << trackId << std::endl;
+    current = trackId;
+    state = State::FADING_IN;
+    timer = fadeSeconds;
+}
+
+void MusicManager::Stop() {
+    if (state == State::IDLE || state == State::FADING_OUT) return;
+
+    queue.StopWithFadeOut(current, scheduleTime(), fadeFrames());
+
+    std::cout << "Stopping music: " << current << std::endl;
+    state = State::FADING_OUT;
+    timer = fadeSeconds;
+}
+
+void MusicManager::Update(float dt) {
+    if (state != State::FADING_IN && state != State::FADING_OUT) return;
+
+    timer -= dt;
+    if (timer > 0.0f) return;
+
+    if (state == State::FADING_IN) {
+        state = State::PLAYING;
+    }
+    else {
+        state = State::IDLE;
+        current = -1;
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "olcPixelGameEngine.h"
+#include "olcPGEX_MiniAudio.h"
+#include "audio_queue.h"
+
+#include <cstdint>
+
+// ============================================================================
+// MUSIC MANAGER
+// ============================================================================
+// Owns the one looping music track. Play() crossfades to a track and Stop()
+// fades out; both are idempotent, so they can be called every frame and only
+// issue audio commands when the request actually changes something. Fades
+// are scheduled on the engine clock and applied by the audio thread, so a
+// crossfade's fade-out and fade-in start on the same sample frame.
+class MusicManager {
+public:
+	enum class State {
+		IDLE,
+		FADING_IN,
+		PLAYING,
+		FADING_OUT
+	};
+
+	MusicManager(olc::MiniAudio& audio, AudioCommandQueue& queue) : audio(audio), queue(queue) {}
+
+	void SetVolume(float v) { volume = v; }
+	void SetFadeSeconds(float seconds) { fadeSeconds = seconds; }
+
+	// Crossfade to trackId (looping). No-op if it's already playing or fading in.
+	void Play(int trackId);
+	// Fade the current track out. No-op if idle or already fading out.
+	void Stop();
+	// Advances the fade timers; never touches audio
+	void Update(float dt);
+
+	State GetState() const { return state; }
+	int GetCurrentTrack() const { return current; }
+
+private:
+	// Fades start slightly in the future so every command lands before its start frame
+	static constexpr uint64_t SCHEDULE_LEAD_MS = 20;
+
+	uint64_t scheduleTime();
+	uint64_t fadeFrames();
+
+	olc::MiniAudio& audio;
+	AudioCommandQueue& queue;
+
+	State state = State::IDLE;
+	int current = -1;
+	float volume = 1.0f;
+	float fadeSeconds = 1.0f;
+	float timer = 0.0f;
+};
@@ -9,6 +9,22 @@ void Player::Reset(const olc::vf2d& startPos) {
     invincibleTimer = 0.0f;
 }
 
+void Player::Save(SnapshotWriter& out) const {
+    out.Write(pos);
+    out.Write(speed);
+    out.Write(r);
+    out.Write(lives);
+    out.Write(invincibleTimer);
+}
+
+void Player::Load(SnapshotReader& in) {
+    in.Read(pos);
+    in.Read(speed);
+    in.Read(r);
+    in.Read(lives);
+    in.Read(invincibleTimer);
+}
+
 void Player::Update(olc::PixelGameEngine* pge, float dt) {
     
     if (invincibleTimer > 0.0f)
@@ -16,10 +32,15 @@ void Player::Update(olc::PixelGameEngine* pge, float dt) {
  
     olc::vf2d dir = { 0.0f, 0.0f };
 
-    if (pge->GetKey(olc::Key::LEFT).bHeld || pge->GetKey(olc::Key::A).bHeld) dir.x -= 1.0f;
-    if (pge->GetKey(olc::Key::RIGHT).bHeld || pge->GetKey(olc::Key::D).bHeld) dir.x += 1.0f;
-    if (pge->GetKey(olc::Key::UP).bHeld || pge->GetKey(olc::Key::W).bHeld) dir.y -= 1.0f;
-    if (pge->GetKey(olc::Key::DOWN).bHeld || pge->GetKey(olc::Key::S).bHeld) dir.y += 1.0f;
+    if (inputOverride) {
+        dir = *inputOverride;
+    }
+    else {
+        if (pge->GetKey(olc::Key::LEFT).bHeld || pge->GetKey(olc::Key::A).bHeld) dir.x -= 1.0f;
+        if (pge->GetKey(olc::Key::RIGHT).bHeld || pge->GetKey(olc::Key::D).bHeld) dir.x += 1.0f;
+        if (pge->GetKey(olc::Key::UP).bHeld || pge->GetKey(olc::Key::W).bHeld) dir.y -= 1.0f;
+        if (pge->GetKey(olc::Key::DOWN).bHeld || pge->GetKey(olc::Key::S).bHeld) dir.y += 1.0f;
+    }
 
 
     if (dir.mag2() > 0) dir = dir.norm();     // normalize to avoid faster diagonal movement
@@ -1,6 +1,7 @@
 #pragma once
 #include "olcPixelGameEngine.h"
 #include "GameConfig.h"
+#include "snapshot.h"
 
 struct Player {
 	olc::vf2d pos;
@@ -12,7 +13,14 @@ struct Player {
 
 	olc::Decal* decal = nullptr;
 
+	// When set, steers the ship instead of the keyboard (bots, scripted runs)
+	const olc::vf2d* inputOverride = nullptr;
+
 	void Reset(const olc::vf2d& startPos);
 	void Update(olc::PixelGameEngine* pge, float dt);
 	void Draw(olc::PixelGameEngine* pge);
+
+	// Snapshot hooks; the decal is re-linked by whoever restores
+	void Save(SnapshotWriter& out) const;
+	void Load(SnapshotReader& in);
 };
\ No newline at end of file
@@ -0,0 +1,176 @@
+#include "replay.h"
+#include "GameConfig.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+namespace {
+    constexpr char REPLAY_MAGIC[4] = { 'S', 'F', 'R', 'P' };
+    constexpr uint16_t REPLAY_VERSION = 3;  // 2: per-subsystem RNG streams, 3: audio hash
+    constexpr uint64_t REPLAY_MAX_TICKS = uint64_t(1) << 24;   // Over 38 hours at the recording tick
+
+    template <typename T>
+    void writeField(std::ofstream& file, const T& value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool readField(std::ifstream& file, T& value) {
+        return bool(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+}
+
+void Replay::Begin(const Header& h) {
+    header = h;
+    header.stateHash = 0;
+    header.audioHash = 0;
+    inputs.clear();
+}
+
+uint8_t Replay::FromDirection(const olc::vf2d& dir) {
+    uint8_t input = 0;
+    if (dir.x < 0.0f) input |= ReplayInput::LEFT;
+    if (dir.x > 0.0f) input |= ReplayInput::RIGHT;
+    if (dir.y < 0.0f) input |= ReplayInput::UP;
+    if (dir.y > 0.0f) input |= ReplayInput::DOWN;
+    return input;
+}
+
+olc::vf2d Replay::ToDirection(uint8_t input) {
+    olc::vf2d dir = { 0.0f, 0.0f };
+    if (input & ReplayInput::LEFT) dir.x -= 1.0f;
+    if (input & ReplayInput::RIGHT) dir.x += 1.0f;
+    if (input & ReplayInput::UP) dir.y -= 1.0f;
+    if (input & ReplayInput::DOWN) dir.y += 1.0f;
+    return dir;
+}
+
+uint64_t Replay::Hash(const void* data, size_t size, uint64_t hash) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::vector<uint8_t> Replay::encode() const {
+    std::vector<uint8_t> data;
+    uint8_t previous = 0;
+
+    for (size_t i = 0; i < inputs.size(); ) {
+        uint8_t delta = inputs[i] ^ previous;
+
+        // Every following tick that repeats this delta joins the run
+        uint64_t run = 1;
+        while (i + run < inputs.size() && uint8_t(inputs[i + run] ^ inputs[i + run - 1]) == delta) run++;
+        i += size_t(run);
+        previous = inputs[i - 1];
+
+        data.push_back(delta);
+        do {
+            uint8_t byte = uint8_t(run & 0x7f);
+            run >>= 7;
+            data.push_back(run ? uint8_t(byte | 0x80) : byte);
+        } while (run);
+    }
+    return data;
+}
+
+bool Replay::decode(const std::vector<uint8_t>& data, size_t ticks) {
+    inputs.clear();
+    inputs.reserve(std::min(ticks, data.size() * 2));
+    uint8_t current = 0;
+
+    for (size_t pos = 0; pos < data.size(); ) {
+        uint8_t delta = data[pos++];
+
+        uint64_t run = 0;
+        int shift = 0;
+        for (;;) {
+            if (pos >= data.size() || shift > 56) return false;
+            uint8_t byte = data[pos++];
+            run |= uint64_t(byte & 0x7f) << shift;
+            shift += 7;
+            if (!(byte & 0x80)) break;
+        }
+        if (run == 0 || run > ticks - inputs.size()) return false;
+
+        for (uint64_t r = 0; r < run; r++) {
+            current ^= delta;
+            inputs.push_back(current);
+        }
+    }
+    return inputs.size() == ticks;
+}
+
+// File: magic, version, header fields, tick count, encoded size, then the encoded masks
+bool Replay::Save(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "ERROR: Could not write replay: " << path << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> data = encode();
+    file.write(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    writeField(file, REPLAY_VERSION);
+    writeField(file, header.seed);
+    writeField(file, header.difficulty);
+    writeField(file, header.level);
+    writeField(file, header.dt);
+    writeField(file, header.stateHash);
+    writeField(file, header.audioHash);
+    writeField(file, uint64_t(inputs.size()));
+    writeField(file, uint64_t(data.size()));
+    file.write(reinterpret_cast<const char*>(data.data()), std::streamsize(data.size()));
+    return bool(file);
+}
+
+bool Replay::Load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "ERROR: Could not open replay: " << path << std::endl;
+        return false;
+    }
+
+    char magic[4] = {};
+    uint16_t version = 0;
+    uint64_t ticks = 0, size = 0;
+    Header h;
+    file.read(magic, sizeof(magic));
+    bool ok = readField(file, version) && readField(file, h.seed) && readField(file, h.difficulty)
+        && readField(file, h.level) && readField(file, h.dt) && readField(file, h.stateHash)
+        && readField(file, h.audioHash) && readField(file, ticks) && readField(file, size);
+
+    if (!ok || !std::equal(magic, magic + 4, REPLAY_MAGIC) || version != REPLAY_VERSION) {
+        std::cerr << "ERROR: Not a replay, or from another version: " << path << std::endl;
+        return false;
+    }
+
+    // The encoded masks must be exactly what is left of the file, and a run never costs
+    // more than two bytes per tick it covers, so anything bigger is corrupt. ticks is
+    // capped first, so ticks * 2 cannot overflow.
+    std::streamoff headerEnd = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::streamoff fileEnd = file.tellg();
+    file.seekg(headerEnd);
+    bool sizeOk = headerEnd >= 0 && fileEnd >= headerEnd && size == uint64_t(fileEnd - headerEnd);
+    bool ticksOk = ticks <= REPLAY_MAX_TICKS && size <= ticks * 2 + 16;
+
+    if (!sizeOk || !ticksOk || h.difficulty > uint8_t(Difficulty::HARD) || !(h.dt > 0.0f)) {
+        std::cerr << "ERROR: Corrupt replay: " << path << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> data(static_cast<size_t>(size));
+    file.read(reinterpret_cast<char*>(data.data()), std::streamsize(size));
+    if (!file || !decode(data, size_t(ticks))) {
+        std::cerr << "ERROR: Corrupt replay: " << path << std::endl;
+        inputs.clear();
+        return false;
+    }
+
+    header = h;
+    return true;
+}
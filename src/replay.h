@@ -0,0 +1,65 @@
+#pragma once
+#include "olcPixelGameEngine.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// REPLAYS
+// ============================================================================
+// Everything a run depends on besides the code: the RNG seed, difficulty,
+// starting level, the fixed tick length, and the ship's input on every tick
+// as a bitmask. Re-simulating from these gives the same run, tick for tick,
+// as long as the build does its float maths the same way; the state hash
+// stored at the end is there to notice when it doesn't.
+//
+// On disk the masks are delta coded (each one XORed with the tick before,
+// so a held key is all zeros) and then run-length coded as pairs of
+// <delta byte, LEB128 run length>. Minutes of play come to a few KB.
+namespace ReplayInput {
+	constexpr uint8_t LEFT  = 1 << 0;
+	constexpr uint8_t RIGHT = 1 << 1;
+	constexpr uint8_t UP    = 1 << 2;
+	constexpr uint8_t DOWN  = 1 << 3;
+}
+
+class Replay {
+public:
+	struct Header {
+		uint32_t seed = 0;
+		uint8_t difficulty = 0;         // Difficulty, as its underlying value
+		uint8_t level = 1;              // Level the run starts on
+		float dt = 1.0f / 60.0f;        // Seconds per tick
+		uint64_t stateHash = 0;         // Game state after the last tick, 0 = not recorded
+		uint64_t audioHash = 0;         // Every sample the simulation mixed, 0 = not recorded
+	};
+
+	// Starts an empty replay
+	void Begin(const Header& header);
+	void Record(uint8_t input) { inputs.push_back(input); }
+
+	// Input for a tick, none past the end
+	uint8_t Input(size_t tick) const { return tick < inputs.size() ? inputs[tick] : 0; }
+	size_t GetTickCount() const { return inputs.size(); }
+
+	Header& GetHeader() { return header; }
+	const Header& GetHeader() const { return header; }
+
+	bool Save(const std::string& path) const;
+	bool Load(const std::string& path);
+
+	// The input bitmask for a movement direction, and back
+	static uint8_t FromDirection(const olc::vf2d& dir);
+	static olc::vf2d ToDirection(uint8_t input);
+
+	// FNV-1a, for hashing game state a field at a time
+	static uint64_t Hash(const void* data, size_t size, uint64_t hash = 14695981039346656037ull);
+
+private:
+	std::vector<uint8_t> encode() const;
+	bool decode(const std::vector<uint8_t>& data, size_t ticks);
+
+	Header header;
+	std::vector<uint8_t> inputs;        // One bitmask per tick
+};
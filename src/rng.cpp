@@ -0,0 +1,49 @@
+#include "rng.h"
+
+void Rng::Seed(uint64_t seed, uint32_t stream) {
+    // SplitMix64 spreads any seed, 0 included, over the whole state
+    auto splitMix = [&seed]() {
+        uint64_t z = (seed += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    };
+
+    uint64_t a = splitMix(), b = splitMix();
+    s[0] = uint32_t(a);
+    s[1] = uint32_t(a >> 32);
+    s[2] = uint32_t(b);
+    s[3] = uint32_t(b >> 32);
+
+    for (uint32_t i = 0; i < stream; i++) Jump();
+}
+
+void Rng::Jump() {
+    static constexpr uint32_t JUMP[] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+
+    uint32_t t[4] = { 0, 0, 0, 0 };
+    for (uint32_t word : JUMP) {
+        for (int bit = 0; bit < 32; bit++) {
+            if (word & (1u << bit)) {
+                t[0] ^= s[0];
+                t[1] ^= s[1];
+                t[2] ^= s[2];
+                t[3] ^= s[3];
+            }
+            Next();
+        }
+    }
+    s[0] = t[0];
+    s[1] = t[1];
+    s[2] = t[2];
+    s[3] = t[3];
+}
+
+void Rng::FillUniform(float* out, size_t count) {
+    for (size_t i = 0; i < count; i++) out[i] = Float();
+}
+
+void Rng::FillRange(float* out, size_t count, float lo, float hi) {
+    FillUniform(out, count);
+    for (size_t i = 0; i < count; i++) out[i] = Lerp(lo, hi, out[i]);
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// ============================================================================
+// RANDOM NUMBER STREAMS
+// ============================================================================
+// xoshiro128** (Blackman & Vigna): 16 bytes of state, a handful of ALU ops
+// per number, and a jump function that skips 2^64 draws. Stream n of a seed
+// starts n jumps in, so every subsystem can draw from its own stream of the
+// same seed without ever overlapping another. Also a standard
+// UniformRandomBitGenerator, so <random> distributions still work with it.
+class Rng {
+public:
+	using result_type = uint32_t;
+
+	explicit Rng(uint64_t seed = 1, uint32_t stream = 0) { Seed(seed, stream); }
+
+	// Restarts the generator at the given stream of a seed
+	void Seed(uint64_t seed, uint32_t stream = 0);
+	// Advances as far as 2^64 calls to Next would
+	void Jump();
+
+	uint32_t Next() {
+		const uint32_t result = rotl(s[1] * 5, 7) * 9;
+		const uint32_t t = s[1] << 9;
+		s[2] ^= s[0];
+		s[3] ^= s[1];
+		s[1] ^= s[2];
+		s[0] ^= s[3];
+		s[2] ^= t;
+		s[3] = rotl(s[3], 11);
+		return result;
+	}
+
+	// Uniform in [0, 1), from the top 24 bits so every value is exact in a float
+	float Float() { return float(Next() >> 8) * (1.0f / 16777216.0f); }
+	// Uniform in [lo, hi)
+	float Range(float lo, float hi) { return Lerp(lo, hi, Float()); }
+	// Uniform in [lo, hi], by multiply and shift (bias below 2^-32 for game-sized ranges)
+	int Int(int lo, int hi) { return lo + int((uint64_t(Next()) * uint64_t(uint32_t(hi - lo) + 1)) >> 32); }
+	// True with probability p
+	bool Chance(float p) { return Float() < p; }
+
+	// Bulk versions: count uniform floats in [0, 1), or in [lo, hi)
+	void FillUniform(float* out, size_t count);
+	void FillRange(float* out, size_t count, float lo, float hi);
+
+	// Maps a [0, 1) value from FillUniform onto [lo, hi)
+	static float Lerp(float lo, float hi, float u) { return lo + (hi - lo) * u; }
+
+	// UniformRandomBitGenerator
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return UINT32_MAX; }
+	result_type operator()() { return Next(); }
+
+private:
+	static uint32_t rotl(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+
+	uint32_t s[4];
+};
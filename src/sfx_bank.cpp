@@ -0,0 +1,221 @@
+#include "sfx_bank.h"
+#include "startup_profiler.h"
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+namespace {
+    constexpr char CACHE_MAGIC[4] = { 'S', 'F', 'X', '1' };
+    constexpr size_t RENDER_BLOCK = 64;     // Frames per oscillator frequency step
+}
+
+SfxBank::SfxBank(olc::MiniAudio& audio, std::string cacheDir) : audio(audio), cacheDir(std::move(cacheDir)) {}
+
+void SfxBank::Add(const std::string& name, const SfxParams& params, int variations, float pitchJitter) {
+    entries.push_back({ name, {} });
+
+    Job job;
+    job.entry = entries.size() - 1;
+    job.cacheFile = cacheDir + "/" + name + ".pcm";
+    job.params = params;
+    jobs.push_back(job);
+
+    // A variation is the same effect played back faster or slower, with its own noise
+    for (int v = 1; v <= variations; v++) {
+        float pitch = 1.0f + rng.Range(-pitchJitter, pitchJitter);
+        job.cacheFile = cacheDir + "/" + name + "_" + std::to_string(v) + ".pcm";
+        job.params = params;
+        job.params.startHz *= pitch;
+        job.params.endHz *= pitch;
+        job.params.duration /= pitch;
+        job.params.seed = params.seed + v;
+        jobs.push_back(job);
+    }
+}
+
+std::vector<float> SfxBank::Render(const SfxParams& params, uint32_t sampleRate) {
+    const size_t frames = size_t(std::max(0.0f, params.duration) * sampleRate);
+    std::vector<float> pcm(frames, 0.0f);
+    if (frames == 0) return pcm;
+
+    ma_waveform_config waveConfig = ma_waveform_config_init(ma_format_f32, 1, sampleRate, params.wave, 1.0, params.startHz);
+    ma_waveform wave;
+    if (ma_waveform_init(&waveConfig, &wave) != MA_SUCCESS) return pcm;
+
+    ma_noise_config noiseConfig = ma_noise_config_init(ma_format_f32, 1, params.noiseType, params.seed, 1.0);
+    ma_noise noise;
+    bool hasNoise = params.noise > 0.0f && ma_noise_init(&noiseConfig, nullptr, &noise) == MA_SUCCESS;
+
+    const float ratio = (params.startHz > 0.0f && params.endHz > 0.0f) ? params.endHz / params.startHz : 1.0f;
+    float noiseBlock[RENDER_BLOCK];
+
+    for (size_t start = 0; start < frames; start += RENDER_BLOCK) {
+        size_t count = std::min(RENDER_BLOCK, frames - start);
+        float t = float(start) / float(frames);
+        ma_waveform_set_frequency(&wave, params.startHz * std::pow(ratio, t));
+        ma_waveform_read_pcm_frames(&wave, pcm.data() + start, count, nullptr);
+
+        if (hasNoise) {
+            ma_noise_read_pcm_frames(&noise, noiseBlock, count, nullptr);
+            for (size_t i = 0; i < count; i++) {
+                pcm[start + i] = pcm[start + i] * (1.0f - params.noise) + noiseBlock[i] * params.noise;
+            }
+        }
+    }
+
+    if (hasNoise) ma_noise_uninit(&noise, nullptr);
+    ma_waveform_uninit(&wave);
+
+    // Envelope: linear attack, then a curved fade that reaches silence on the last frame
+    const float attackFrames = std::max(1.0f, params.attack * sampleRate);
+    for (size_t i = 0; i < frames; i++) {
+        float attack = std::min(1.0f, float(i) / attackFrames);
+        float fade = std::pow(1.0f - float(i) / float(frames), params.decayCurve);
+        pcm[i] *= params.amplitude * attack * fade;
+    }
+    return pcm;
+}
+
+// FNV-1a over each field, so padding never reaches the hash
+uint64_t SfxBank::hashParams(const SfxParams& params, uint32_t sampleRate) {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&](const void* data, size_t size) {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    };
+
+    int32_t wave = int32_t(params.wave), noiseType = int32_t(params.noiseType);
+    mix(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    mix(&wave, sizeof(wave));
+    mix(&params.startHz, sizeof(float));
+    mix(&params.endHz, sizeof(float));
+    mix(&params.duration, sizeof(float));
+    mix(&params.attack, sizeof(float));
+    mix(&params.decayCurve, sizeof(float));
+    mix(&params.noise, sizeof(float));
+    mix(&noiseType, sizeof(noiseType));
+    mix(&params.amplitude, sizeof(float));
+    mix(&params.seed, sizeof(params.seed));
+    mix(&sampleRate, sizeof(sampleRate));
+    return hash;
+}
+
+// Cache file: magic, parameter hash, frame count, then mono f32 samples
+bool SfxBank::readCache(Job& job, uint32_t sampleRate) {
+    std::ifstream file(job.cacheFile, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    char magic[4] = {};
+    uint64_t hash = 0, frames = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&hash), sizeof(hash));
+    file.read(reinterpret_cast<char*>(&frames), sizeof(frames));
+    if (!file || !std::equal(magic, magic + 4, CACHE_MAGIC) || hash != job.hash) return false;
+
+    // A bigger count than the parameters could produce means the file is corrupt
+    if (frames > uint64_t(std::max(0.0f, job.params.duration) * sampleRate) + 1) return false;
+
+    job.pcm.resize(size_t(frames));
+    file.read(reinterpret_cast<char*>(job.pcm.data()), std::streamsize(frames * sizeof(float)));
+    return bool(file);
+}
+
+void SfxBank::writeCache(const Job& job) {
+    std::ofstream file(job.cacheFile, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return;
+
+    uint64_t frames = job.pcm.size();
+    file.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    file.write(reinterpret_cast<const char*>(&job.hash), sizeof(job.hash));
+    file.write(reinterpret_cast<const char*>(&frames), sizeof(frames));
+    file.write(reinterpret_cast<const char*>(job.pcm.data()), std::streamsize(frames * sizeof(float)));
+}
+
+bool SfxBank::Build() {
+    auto start = StartupProfiler::Clock::now();
+    const uint32_t sampleRate = audio.GetDeviceSettings().m_sample_rate;
+
+    std::error_code ec;
+    std::filesystem::create_directories(cacheDir, ec);
+    if (ec) {
+        std::cerr << "ERROR: Could not create SFX cache directory: " << cacheDir << std::endl;
+    }
+
+    // Each worker takes the next job until none are left; every job touches only itself
+    std::atomic<size_t> next{ 0 };
+    auto worker = [&]() {
+        for (size_t i = next++; i < jobs.size(); i = next++) {
+            Job& job = jobs[i];
+            Trace::Scope traced("sfx render", job.cacheFile);
+            job.hash = hashParams(job.params, sampleRate);
+            job.fromCache = readCache(job, sampleRate);
+            if (!job.fromCache) {
+                job.pcm = Render(job.params, sampleRate);
+                writeCache(job);
+            }
+        }
+    };
+
+    size_t threadCount = std::min<size_t>(jobs.size(), std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < threadCount; t++) {
+        threads.emplace_back([&]() {
+            Trace::SetThreadName("sfx worker");
+            worker();
+        });
+    }
+    worker();
+    for (auto& t : threads) t.join();
+
+    // MiniAudio isn't thread safe, so registering the buffers stays on this thread
+    bool ok = true;
+    for (auto& job : jobs) {
+        if (job.fromCache) stats.cached++;
+        else stats.rendered++;
+
+        try {
+            std::string name = "sfx:" + std::filesystem::path(job.cacheFile).stem().string();
+            entries[job.entry].ids.push_back(audio.LoadSoundFromPcm(name, std::move(job.pcm), 1, sampleRate));
+            stats.sounds++;
+        }
+        catch (const std::exception& e) {
+            std::cerr << "ERROR: Could not load procedural sound " << job.cacheFile << ": " << e.what() << std::endl;
+            ok = false;
+        }
+    }
+    jobs.clear();
+
+    stats.ms = StartupProfiler::MsSince(start);
+    return ok;
+}
+
+const SfxBank::Entry* SfxBank::find(const std::string& name) const {
+    auto it = std::find_if(entries.begin(), entries.end(),
+        [&](const Entry& e) { return e.name == name; });
+    return (it == entries.end()) ? nullptr : &*it;
+}
+
+int SfxBank::Get(const std::string& name) const {
+    const Entry* entry = find(name);
+    return (entry && !entry->ids.empty()) ? entry->ids[0] : -1;
+}
+
+int SfxBank::Variation(const std::string& name) {
+    const Entry* entry = find(name);
+    if (!entry || entry->ids.empty()) return -1;
+    return entry->ids[size_t(rng.Int(0, int(entry->ids.size()) - 1))];
+}
+
+std::vector<int> SfxBank::GetIds() const {
+    std::vector<int> ids;
+    for (const auto& e : entries) ids.insert(ids.end(), e.ids.begin(), e.ids.end());
+    return ids;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "olcPGEX_MiniAudio.h"
+#include "rng.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// PROCEDURAL SOUND EFFECTS
+// ============================================================================
+// Synthesises short effects from miniaudio's waveform and noise generators
+// straight into PCM, every effect on its own worker at load, and registers
+// the buffers with MiniAudio as already decoded sounds. Rendered PCM is
+// cached on disk keyed by a hash of its parameters, so a warm start skips
+// the synthesis as well as any file decode.
+struct SfxParams {
+	ma_waveform_type wave = ma_waveform_type_square;
+	float startHz = 440.0f;
+	float endHz = 440.0f;           // Swept exponentially from startHz over the duration
+	float duration = 0.2f;          // Seconds
+	float attack = 0.005f;          // Seconds to reach full volume
+	float decayCurve = 1.0f;        // 1 = linear fade to silence, higher fades faster
+	float noise = 0.0f;             // 0 = pure tone .. 1 = pure noise
+	ma_noise_type noiseType = ma_noise_type_white;
+	float amplitude = 0.5f;
+	int32_t seed = 1;               // Noise seed, so renders repeat exactly
+};
+
+class SfxBank {
+public:
+	struct Stats {
+		int sounds = 0;
+		int rendered = 0;
+		int cached = 0;
+		double ms = 0.0;
+	};
+
+	SfxBank(olc::MiniAudio& audio, std::string cacheDir);
+
+	// Adds an effect. variations > 0 also renders that many copies with their own
+	// noise seed, pitched by up to +-pitchJitter (0.08 = 8%)
+	void Add(const std::string& name, const SfxParams& params, int variations = 0, float pitchJitter = 0.0f);
+
+	// Renders everything added (or reads it back from the cache) in parallel and loads it into MiniAudio
+	bool Build();
+
+	// Sound ID of an effect, -1 if it isn't built
+	int Get(const std::string& name) const;
+	// Sound ID of a random variation of an effect, the original included
+	int Variation(const std::string& name);
+	// Every sound ID the bank loaded
+	std::vector<int> GetIds() const;
+
+	const Stats& GetStats() const { return stats; }
+
+	// Renders mono f32 PCM for one effect
+	static std::vector<float> Render(const SfxParams& params, uint32_t sampleRate);
+
+private:
+	struct Entry {
+		std::string name;
+		std::vector<int> ids;               // [0] is the original, the rest variations
+	};
+
+	struct Job {
+		size_t entry = 0;
+		std::string cacheFile;
+		SfxParams params;
+		uint64_t hash = 0;
+		std::vector<float> pcm;
+		bool fromCache = false;
+	};
+
+	static uint64_t hashParams(const SfxParams& params, uint32_t sampleRate);
+	static bool readCache(Job& job, uint32_t sampleRate);
+	static void writeCache(const Job& job);
+	const Entry* find(const std::string& name) const;
+
+	olc::MiniAudio& audio;
+	std::string cacheDir;
+	std::vector<Entry> entries;
+	std::vector<Job> jobs;                  // Pending until Build, in entry order
+	Rng rng{ 0x5f3759df };
+	Stats stats;
+};
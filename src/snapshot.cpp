@@ -0,0 +1,35 @@
+#include "snapshot.h"
+#include <algorithm>
+
+namespace {
+    constexpr char SNAPSHOT_MAGIC[4] = { 'S', 'F', 'S', 'N' };
+    // Magic, version, padding, payload size
+    constexpr size_t HEADER_SIZE = sizeof(SNAPSHOT_MAGIC) + sizeof(uint16_t) * 2 + sizeof(uint32_t);
+}
+
+SnapshotWriter::SnapshotWriter(std::vector<uint8_t>& out) : out(out), start(out.size()) {
+    out.insert(out.end(), SNAPSHOT_MAGIC, SNAPSHOT_MAGIC + sizeof(SNAPSHOT_MAGIC));
+    Write(SNAPSHOT_VERSION);
+    Write(uint16_t(0));
+    Write(uint32_t(0));
+}
+
+void SnapshotWriter::Finish() {
+    uint32_t payload = uint32_t(out.size() - start - HEADER_SIZE);
+    std::memcpy(out.data() + start + HEADER_SIZE - sizeof(payload), &payload, sizeof(payload));
+}
+
+SnapshotReader::SnapshotReader(const uint8_t* data, size_t size) : data(data), size(size) {
+    if (size < HEADER_SIZE || !std::equal(SNAPSHOT_MAGIC, SNAPSHOT_MAGIC + sizeof(SNAPSHOT_MAGIC), data)) {
+        ok = false;
+        return;
+    }
+    pos = sizeof(SNAPSHOT_MAGIC);
+
+    uint16_t version = 0, padding = 0;
+    uint32_t payload = 0;
+    Read(version);
+    Read(padding);
+    Read(payload);
+    if (version != SNAPSHOT_VERSION || payload != size - HEADER_SIZE) ok = false;
+}
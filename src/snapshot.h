@@ -0,0 +1,84 @@
+#pragma once
+#include "olcPixelGameEngine.h"
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// ============================================================================
+// WORLD SNAPSHOTS
+// ============================================================================
+// The gameplay state as one flat blob: a versioned header, then every
+// object's fields, written one at a time by its Save hook and read back in
+// the same order by its Load hook. Pointers are never written (the game
+// re-links decals after a restore), so a blob stays valid across runs of the
+// same build. A busy frame is a few KB, and a restore is a run of memcpys
+// into vectors that keep their capacity.
+//
+// Bump SNAPSHOT_VERSION whenever a Save hook changes what it writes.
+constexpr uint16_t SNAPSHOT_VERSION = 1;
+
+class SnapshotWriter {
+public:
+	explicit SnapshotWriter(std::vector<uint8_t>& out);
+
+	template <typename T>
+	void Write(const T& value) {
+		static_assert(std::is_trivially_copyable<T>::value, "Snapshot fields must be plain data");
+		size_t at = out.size();
+		out.resize(at + sizeof(T));
+		std::memcpy(out.data() + at, &value, sizeof(T));
+	}
+	void Write(const olc::vf2d& v) { Write(v.x); Write(v.y); }
+
+	// Count, then each item's Save
+	template <typename T>
+	void WriteVector(const std::vector<T>& items) {
+		Write(uint32_t(items.size()));
+		for (const auto& item : items) item.Save(*this);
+	}
+
+	// Fills in the header's payload size; the blob is complete after this
+	void Finish();
+
+private:
+	std::vector<uint8_t>& out;
+	size_t start;
+};
+
+class SnapshotReader {
+public:
+	// Checks the header; Ok() is false if data isn't a snapshot of this version
+	SnapshotReader(const uint8_t* data, size_t size);
+
+	template <typename T>
+	bool Read(T& value) {
+		static_assert(std::is_trivially_copyable<T>::value, "Snapshot fields must be plain data");
+		if (!ok || size - pos < sizeof(T)) return ok = false;
+		std::memcpy(&value, data + pos, sizeof(T));
+		pos += sizeof(T);
+		return true;
+	}
+	bool Read(olc::vf2d& v) { return Read(v.x) && Read(v.y); }
+
+	// Count, then each item's Load. Existing capacity is reused
+	template <typename T>
+	bool ReadVector(std::vector<T>& items) {
+		uint32_t count = 0;
+		if (!Read(count) || count > size - pos) return ok = false;
+		items.resize(count);
+		for (auto& item : items) item.Load(*this);
+		return ok;
+	}
+
+	bool Ok() const { return ok; }
+	// True once everything was read without running short, with nothing left over
+	bool Done() const { return ok && pos == size; }
+
+private:
+	const uint8_t* data;
+	size_t size;
+	size_t pos = 0;
+	bool ok = true;
+};
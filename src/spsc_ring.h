@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+// ============================================================================
+// SPSC RING BUFFER
+// ============================================================================
+// Fixed-size, lock-free queue for exactly one producer thread and one
+// consumer thread. Capacity must be a power of two; one slot is never used
+// so a full ring can be told apart from an empty one.
+template <typename T, size_t Capacity>
+class SpscRing {
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+	// Producer only. Returns false (and drops item) if the ring is full.
+	bool Push(const T& item) {
+		size_t head = writeIndex.load(std::memory_order_relaxed);
+		size_t next = (head + 1) & (Capacity - 1);
+		if (next == readIndex.load(std::memory_order_acquire)) return false;
+
+		slots[head] = item;
+		writeIndex.store(next, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer only. Returns false if the ring is empty.
+	bool Pop(T& item) {
+		size_t tail = readIndex.load(std::memory_order_relaxed);
+		if (tail == writeIndex.load(std::memory_order_acquire)) return false;
+
+		item = slots[tail];
+		readIndex.store((tail + 1) & (Capacity - 1), std::memory_order_release);
+		return true;
+	}
+
+	// Approximate when called while the other thread is active
+	size_t Size() const {
+		size_t head = writeIndex.load(std::memory_order_acquire);
+		size_t tail = readIndex.load(std::memory_order_acquire);
+		return (head - tail) & (Capacity - 1);
+	}
+
+	bool Empty() const { return Size() == 0; }
+	static constexpr size_t MaxSize() { return Capacity - 1; }
+
+private:
+	// Each index on its own cache line so the two threads don't false-share
+	alignas(64) std::atomic<size_t> writeIndex{ 0 };
+	alignas(64) std::atomic<size_t> readIndex{ 0 };
+	alignas(64) T slots[Capacity];
+};
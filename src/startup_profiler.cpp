@@ -0,0 +1,89 @@
+#include "startup_profiler.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+void StartupProfiler::AddPhaseTime(const std::string& phase, double ms) {
+    auto it = std::find_if(phases.begin(), phases.end(),
+        [&](const Phase& p) { return p.name == phase; });
+    if (it == phases.end()) {
+        phases.push_back({ phase, ms });
+        return;
+    }
+    it->ms += ms;
+}
+
+void StartupProfiler::RecordAsset(const std::string& path, const std::string& type, size_t bytes, double ms) {
+    assets.push_back({ path, type, bytes, ms });
+}
+
+void StartupProfiler::Finish() {
+    totalMs = MsSince(start);
+}
+
+void StartupProfiler::PrintSummary() const {
+    size_t totalBytes = 0;
+    for (const auto& a : assets) totalBytes += a.bytes;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Startup: " << totalMs << " ms, " << assets.size() << " assets, " << totalBytes / 1024 << " KB" << std::endl;
+    for (const auto& p : phases) {
+        std::cout << "  - " << p.name << ": " << p.ms << " ms" << std::endl;
+    }
+
+    // The few slowest assets are usually the ones worth looking at
+    std::vector<AssetRecord> slowest = assets;
+    std::sort(slowest.begin(), slowest.end(),
+        [](const AssetRecord& a, const AssetRecord& b) { return a.ms > b.ms; });
+    if (slowest.size() > 5) slowest.resize(5);
+    for (const auto& a : slowest) {
+        std::cout << "  * " << a.path << " (" << a.type << "): " << a.ms << " ms, " << a.bytes / 1024 << " KB" << std::endl;
+    }
+
+    if (budgetMs > 0.0) {
+        std::cout << "  Budget: " << budgetMs << " ms - " << (IsOverBudget() ? "EXCEEDED" : "OK") << std::endl;
+    }
+    std::cout << std::defaultfloat;
+}
+
+static std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+bool StartupProfiler::WriteJson(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "ERROR: Could not write startup report: " << path << std::endl;
+        return false;
+    }
+
+    file << std::fixed << std::setprecision(3);
+    file << "{\n";
+    file << "  \"total_ms\": " << totalMs << ",\n";
+    file << "  \"budget_ms\": " << budgetMs << ",\n";
+    file << "  \"over_budget\": " << (IsOverBudget() ? "true" : "false") << ",\n";
+
+    file << "  \"phases\": [\n";
+    for (size_t i = 0; i < phases.size(); i++) {
+        file << "    { \"name\": \"" << jsonEscape(phases[i].name) << "\", \"ms\": " << phases[i].ms << " }"
+             << (i + 1 < phases.size() ? "," : "") << "\n";
+    }
+    file << "  ],\n";
+
+    file << "  \"assets\": [\n";
+    for (size_t i = 0; i < assets.size(); i++) {
+        const auto& a = assets[i];
+        file << "    { \"path\": \"" << jsonEscape(a.path) << "\", \"type\": \"" << a.type
+             << "\", \"bytes\": " << a.bytes << ", \"ms\": " << a.ms << " }"
+             << (i + 1 < assets.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n";
+    file << "}\n";
+    return true;
+}
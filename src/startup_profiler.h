@@ -0,0 +1,71 @@
+#pragma once
+#include "trace.h"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// STARTUP PROFILER
+// ============================================================================
+// Times each phase of the cold start and records what every asset cost.
+// Construct it before anything else so the total covers the whole launch.
+class StartupProfiler {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	struct Phase {
+		std::string name;
+		double ms = 0.0;
+	};
+
+	struct AssetRecord {
+		std::string path;
+		std::string type;
+		size_t bytes = 0;
+		double ms = 0.0;
+	};
+
+	// Adds the time between construction and destruction to a phase, and
+	// puts it on the trace timeline when tracing
+	class Scope {
+	public:
+		Scope(StartupProfiler& profiler, const std::string& phase)
+			: profiler(profiler), phase(phase), start(Clock::now()) {}
+		~Scope() {
+			Trace::Complete(nullptr, start, Clock::now(), phase.c_str());
+			profiler.AddPhaseTime(phase, StartupProfiler::MsSince(start));
+		}
+	private:
+		StartupProfiler& profiler;
+		std::string phase;
+		Clock::time_point start;
+	};
+
+	StartupProfiler() : start(Clock::now()) {}
+
+	static double MsSince(Clock::time_point since) {
+		return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+	}
+
+	void AddPhaseTime(const std::string& phase, double ms);
+	void RecordAsset(const std::string& path, const std::string& type, size_t bytes, double ms);
+
+	// Stops the clock; call once the game is ready to show its first frame
+	void Finish();
+	double GetTotalMs() const { return totalMs; }
+
+	// 0 disables the budget
+	void SetBudgetMs(double ms) { budgetMs = ms; }
+	bool IsOverBudget() const { return budgetMs > 0.0 && totalMs > budgetMs; }
+
+	void PrintSummary() const;
+	bool WriteJson(const std::string& path) const;
+
+private:
+	Clock::time_point start;
+	double totalMs = 0.0;
+	double budgetMs = 0.0;
+	std::vector<Phase> phases;
+	std::vector<AssetRecord> assets;
+};
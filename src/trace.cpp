@@ -0,0 +1,239 @@
+#include "trace.h"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Trace {
+    namespace detail {
+        std::atomic<bool> active{ false };
+    }
+
+    namespace {
+        struct Event {
+            const char* name;
+            int64_t startNs;
+            int64_t durationNs;
+            char phase;                     // 'X' complete, 'i' instant
+            char detail[DETAIL_CHARS];      // Empty when unused; 64 bytes in all
+        };
+
+        // Owned by one thread, which is the only one to append; readers see
+        // every event below count
+        struct ThreadBuffer {
+            uint32_t tid = 0;
+            std::string name;               // Guarded by registryMutex
+            const char* reservedFor = nullptr;  // Fixed once reserved, so claiming reads it without the lock
+            std::atomic<bool> claimed{ true };  // False while a reserved buffer waits for its thread
+            std::unique_ptr<Event[]> events;
+            size_t capacity = 0;
+            std::atomic<size_t> count{ 0 };
+            std::atomic<uint64_t> dropped{ 0 };
+        };
+
+        std::mutex registryMutex;
+        // Buffers outlive their threads, so the startup workers still show up
+        std::vector<std::unique_ptr<ThreadBuffer>> registry;
+        size_t eventsPerBuffer = 0;
+        Clock::time_point origin;
+
+        // Written under registryMutex before reservedCount is raised, read without it
+        std::array<ThreadBuffer*, MAX_RESERVED> reserved{};
+        std::atomic<size_t> reservedCount{ 0 };
+
+        thread_local ThreadBuffer* local = nullptr;
+        thread_local const char* localName = nullptr;   // Last name set, so repeats skip the lock
+
+        // Caller holds registryMutex
+        ThreadBuffer* addBuffer() {
+            auto buffer = std::make_unique<ThreadBuffer>();
+            buffer->tid = uint32_t(registry.size() + 1);
+            buffer->capacity = eventsPerBuffer;
+            buffer->events.reset(new Event[eventsPerBuffer]);
+            registry.push_back(std::move(buffer));
+            return registry.back().get();
+        }
+
+        ThreadBuffer* localBuffer() {
+            if (local) return local;
+
+            std::lock_guard<std::mutex> lock(registryMutex);
+            local = addBuffer();
+            return local;
+        }
+
+        // Takes over a buffer reserved under this name, if one is still free
+        bool claimReserved(const char* name) {
+            size_t count = reservedCount.load(std::memory_order_acquire);
+            for (size_t i = 0; i < count; i++) {
+                ThreadBuffer* buffer = reserved[i];
+                bool expected = false;
+                if (std::strcmp(buffer->reservedFor, name) == 0 && buffer->claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                    local = buffer;
+                    localName = name;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        int64_t sinceOrigin(Clock::time_point t) {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(t - origin).count();
+        }
+
+        void record(const char* name, char phase, Clock::time_point start, Clock::time_point end, const char* detail) {
+            ThreadBuffer* buffer = localBuffer();
+            size_t at = buffer->count.load(std::memory_order_relaxed);
+            if (at == buffer->capacity) {
+                buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            Event& e = buffer->events[at];
+            e.name = name;
+            e.startNs = sinceOrigin(start);
+            e.durationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+            e.phase = phase;
+            e.detail[0] = '\0';
+            if (detail) {
+                std::strncpy(e.detail, detail, DETAIL_CHARS - 1);
+                e.detail[DETAIL_CHARS - 1] = '\0';
+            }
+            buffer->count.store(at + 1, std::memory_order_release);
+        }
+
+        void writeString(std::ostream& out, const char* s) {
+            out << '"';
+            for (; *s; s++) {
+                unsigned char c = static_cast<unsigned char>(*s);
+                if (c == '"' || c == '\\') out << '\\' << *s;
+                else if (c < 0x20) out << ' ';
+                else out << *s;
+            }
+            out << '"';
+        }
+    }
+
+    void Start(size_t eventsPerThread) {
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            if (registry.empty()) {
+                eventsPerBuffer = std::max<size_t>(eventsPerThread, 1);
+                origin = Clock::now();
+            }
+        }
+        detail::active.store(true, std::memory_order_relaxed);
+    }
+
+    void Stop() {
+        detail::active.store(false, std::memory_order_relaxed);
+    }
+
+    void SetThreadName(const char* name) {
+        if (!IsActive() || name == localName) return;
+        if (!local && claimReserved(name)) return;
+        ThreadBuffer* buffer = localBuffer();
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffer->name = name;
+        localName = name;
+    }
+
+    void Reserve(const char* name) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        size_t count = reservedCount.load(std::memory_order_relaxed);
+        if (count == MAX_RESERVED || eventsPerBuffer == 0) return;
+
+        ThreadBuffer* buffer = addBuffer();
+        buffer->name = name;
+        buffer->reservedFor = name;
+        buffer->claimed.store(false, std::memory_order_relaxed);
+        reserved[count] = buffer;
+        reservedCount.store(count + 1, std::memory_order_release);
+    }
+
+    void Complete(const char* name, Clock::time_point start, Clock::time_point end, const char* detail) {
+        if (IsActive()) record(name, 'X', start, end, detail);
+    }
+
+    void Instant(const char* name, const char* detail) {
+        if (!IsActive()) return;
+        auto now = Clock::now();
+        record(name, 'i', now, now, detail);
+    }
+
+    bool Write(const std::string& path) {
+        std::ofstream file(path);
+        if (!file.is_open()) {
+            std::cerr << "ERROR: Could not write trace: " << path << std::endl;
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+        size_t events = 0;
+        uint64_t dropped = 0;
+
+        // Timestamps are microseconds; keeping the nanoseconds lets short scopes still show a width
+        file << std::fixed << std::setprecision(3);
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        file << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Operation Starfall\"}}";
+
+        for (const auto& buffer : registry) {
+            if (!buffer->claimed.load(std::memory_order_acquire)) continue;   // Reserved for a thread that never ran
+
+            file << ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->tid << ",\"args\":{\"name\":";
+            writeString(file, buffer->name.empty() ? ("thread " + std::to_string(buffer->tid)).c_str() : buffer->name.c_str());
+            file << "}}";
+            file << ",\n{\"ph\":\"M\",\"name\":\"thread_sort_index\",\"pid\":1,\"tid\":" << buffer->tid
+                 << ",\"args\":{\"sort_index\":" << buffer->tid << "}}";
+
+            size_t count = buffer->count.load(std::memory_order_acquire);
+            for (size_t i = 0; i < count; i++) {
+                const Event& e = buffer->events[i];
+                file << ",\n{\"ph\":\"" << e.phase << "\",\"name\":";
+                writeString(file, e.name ? e.name : e.detail);
+                file << ",\"pid\":1,\"tid\":" << buffer->tid << ",\"ts\":" << e.startNs / 1000.0;
+                if (e.phase == 'X') file << ",\"dur\":" << e.durationNs / 1000.0;
+                else file << ",\"s\":\"t\"";
+                if (e.name && e.detail[0]) {
+                    file << ",\"args\":{\"detail\":";
+                    writeString(file, e.detail);
+                    file << "}";
+                }
+                file << "}";
+            }
+            events += count;
+            dropped += buffer->dropped.load(std::memory_order_relaxed);
+        }
+        file << "\n]}\n";
+
+        size_t threads = size_t(std::count_if(registry.begin(), registry.end(),
+            [](const std::unique_ptr<ThreadBuffer>& b) { return b->claimed.load(std::memory_order_relaxed); }));
+        std::cout << "Trace (" << events << " events, " << threads << " threads";
+        if (dropped > 0) std::cout << ", " << dropped << " dropped";
+        std::cout << ") written to: " << path << std::endl;
+        return bool(file);
+    }
+
+    Session::Session(size_t eventsPerThread, std::initializer_list<const char*> realtimeThreads) {
+        const char* env = std::getenv("STARFALL_TRACE");
+        if (!env || !*env) return;
+
+        path = env;
+        Start(eventsPerThread);
+        SetThreadName("main");
+        for (const char* name : realtimeThreads) Reserve(name);
+    }
+
+    Session::~Session() {
+        if (path.empty()) return;
+        Stop();
+        Write(path);
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+
+// ============================================================================
+// TRACE EVENTS
+// ============================================================================
+// Timeline tracing for every thread the game runs: the engine thread, the
+// audio device (or null device) thread, the audio control thread, the asset
+// watcher and the startup workers. Events go into a buffer owned by the
+// thread that records them, so recording never takes a lock; a buffer is
+// allocated the first time its thread records while tracing is on, and once
+// it is full further events are counted as dropped. Threads that must never
+// allocate or lock, like the audio device callback, get theirs reserved up
+// front under the name they will give themselves.
+//
+// Write() produces Chrome trace-event JSON, which loads in about:tracing and
+// ui.perfetto.dev. Event names must be string literals (only the pointer is
+// kept); the optional detail is copied, truncated to Trace::DETAIL_CHARS.
+// A null name shows the detail as the name, for labels built at runtime.
+//
+// While tracing is off every call is a single relaxed atomic load.
+namespace Trace {
+	using Clock = std::chrono::steady_clock;
+
+	constexpr size_t DETAIL_CHARS = 39;
+
+	namespace detail {
+		extern std::atomic<bool> active;
+	}
+
+	inline bool IsActive() { return detail::active.load(std::memory_order_relaxed); }
+
+	// eventsPerThread is fixed once the first buffer exists
+	void Start(size_t eventsPerThread);
+	void Stop();
+
+	// Labels the calling thread's row in the viewer; cheap to repeat
+	void SetThreadName(const char* name);
+
+	// Allocates a buffer now, on the calling thread, for a thread that will call
+	// SetThreadName(name) before it records anything. The first such thread takes
+	// it over without allocating or locking. Call after Start; up to MAX_RESERVED
+	constexpr size_t MAX_RESERVED = 8;
+	void Reserve(const char* name);
+
+	void Complete(const char* name, Clock::time_point start, Clock::time_point end, const char* detail = nullptr);
+	void Instant(const char* name, const char* detail = nullptr);
+
+	// Every event recorded so far, from all threads. Safe while other threads
+	// are still recording; anything they add meanwhile may be left out
+	bool Write(const std::string& path);
+
+	// One complete event from construction to destruction
+	class Scope {
+	public:
+		explicit Scope(const char* name, const char* detail = nullptr)
+			: name(name), detail(detail), on(IsActive()) {
+			if (on) start = Clock::now();
+		}
+		Scope(const char* name, const std::string& detail) : Scope(name, detail.c_str()) {}
+		~Scope() { if (on) Complete(name, start, Clock::now(), detail); }
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		const char* name;
+		const char* detail;     // Must outlive the scope
+		bool on;
+		Clock::time_point start;
+	};
+
+	// Traces the whole run when STARFALL_TRACE names an output file: starts on
+	// construction, reserving buffers for the named real-time threads, and
+	// writes the file on destruction. Make it the owner's first member so it
+	// covers everything created after it and is written only once the threads
+	// of everything destroyed before it have been joined
+	class Session {
+	public:
+		explicit Session(size_t eventsPerThread, std::initializer_list<const char*> realtimeThreads = {});
+		~Session();
+
+	private:
+		std::string path;
+	};
+}